@@ -50,6 +50,7 @@ fast_downward_plugin(
 
         abstract_task
         axioms
+        compressed_state_pool
         evaluation_context
         evaluation_result
         evaluator
@@ -77,7 +78,7 @@ fast_downward_plugin(
         state_registry_base
         task_proxy
 
-    DEPENDS CAUSAL_GRAPH INT_PACKER ORDERED_SET SEGMENTED_VECTOR SUCCESSOR_GENERATOR TASK_PROPERTIES
+    DEPENDS CAUSAL_GRAPH INT_HASH_SET INT_PACKER ORDERED_SET SEGMENTED_VECTOR SUCCESSOR_GENERATOR TASK_PROPERTIES
     CORE_PLUGIN
 )
 
@@ -130,6 +131,13 @@ fast_downward_plugin(
         open_lists/alternation_open_list
 )
 
+fast_downward_plugin(
+    NAME BUCKET_OPEN_LIST
+    HELP "Open lists that store their buckets in an array indexed by the key"
+    SOURCES
+        open_lists/bucket_open_list
+)
+
 fast_downward_plugin(
     NAME EPSILON_GREEDY_OPEN_LIST
     HELP "Open list that chooses an entry randomly with probability epsilon"
@@ -181,6 +189,14 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME INT_HASH_SET
+    HELP "Hash set using open addressing"
+    SOURCES
+        algorithms/int_hash_set
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME INT_PACKER
     HELP "Greedy bin packing algorithm to pack integer variables with small domains tightly into memory"
@@ -310,7 +326,7 @@ fast_downward_plugin(
     HELP "Basic classes used for all search engines"
     SOURCES
         search_engines/search_common
-    DEPENDS ALTERNATION_OPEN_LIST G_EVALUATOR STANDARD_SCALAR_OPEN_LIST SUM_EVALUATOR TIEBREAKING_OPEN_LIST WEIGHTED_EVALUATOR
+    DEPENDS ALTERNATION_OPEN_LIST BUCKET_OPEN_LIST G_EVALUATOR STANDARD_SCALAR_OPEN_LIST SUM_EVALUATOR TIEBREAKING_OPEN_LIST WEIGHTED_EVALUATOR
     DEPENDENCY_ONLY
 )
 
@@ -724,12 +740,14 @@ fast_downward_plugin(
         redblack/painting
         redblack/painting_utils
         redblack/plugins
+        redblack/portfolio_redblack_search
         redblack/rb_data
         redblack/rb_ff_heuristic
         redblack/rb_lazy_search
         redblack/rb_search_engine
         redblack/red_actions_manager
         redblack/search_space
+        redblack/shared_task_data
         redblack/state
         redblack/state_registry
         redblack/state_saturation
@@ -737,6 +755,7 @@ fast_downward_plugin(
         redblack/mercury/dtg_operators
         redblack/mercury/red_black_DAG_fact_following_heuristic
         redblack/mercury/red_black_operator
+        redblack/mercury/semi_relaxed_state
         redblack/mercury/graph_algorithms/scc
         redblack/mercury/graph_algorithms/topological_sort
         redblack/mercury/graph_algorithms/transitive_closure
@@ -0,0 +1,148 @@
+#ifndef ALGORITHMS_INT_HASH_SET_H
+#define ALGORITHMS_INT_HASH_SET_H
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/*
+  IntHashSet is a hash set for non-negative integer keys that are interpreted
+  by the given hash and equality functions, e.g. ids of states that are
+  compared by their packed data.
+
+  It uses open addressing with linear probing. The buckets are stored in a
+  single array, and each bucket holds the key together with its hash value.
+  Compared to std::unordered_set, this saves the heap node per key. Since the
+  equality function is only called for keys with the same hash value and
+  growing the table reuses the stored hash values, neither is called for the
+  keys that are already in the set when the set grows. This matters if the
+  hash function has to look at the data of the key, like for states.
+
+  The hash values are truncated to 32 bits. The low bits determine the bucket,
+  so they should be of high quality (see utils/hash.h).
+*/
+
+namespace int_hash_set {
+template<typename Hasher, typename Equal>
+class IntHashSet {
+    using KeyType = int;
+    using HashType = std::uint32_t;
+
+    static constexpr KeyType EMPTY_BUCKET_KEY = -1;
+    static constexpr int MIN_CAPACITY = 16;
+    // grow when more than MAX_LOAD_NUMERATOR / MAX_LOAD_DENOMINATOR of the buckets are used
+    static constexpr int MAX_LOAD_NUMERATOR = 3;
+    static constexpr int MAX_LOAD_DENOMINATOR = 4;
+
+    struct Bucket {
+        KeyType key;
+        HashType hash;
+
+        Bucket()
+            : key(EMPTY_BUCKET_KEY),
+              hash(0) {
+        }
+
+        Bucket(KeyType key, HashType hash)
+            : key(key),
+              hash(hash) {
+        }
+
+        bool is_empty() const {
+            return key == EMPTY_BUCKET_KEY;
+        }
+    };
+
+    Hasher hasher;
+    Equal equal;
+    std::vector<Bucket> buckets;
+    int num_entries;
+
+    std::size_t get_bucket(HashType hash) const {
+        assert((buckets.size() & (buckets.size() - 1)) == 0);
+        return hash & (buckets.size() - 1);
+    }
+
+    std::size_t get_next_bucket(std::size_t bucket) const {
+        return (bucket + 1) & (buckets.size() - 1);
+    }
+
+    void insert_unique(const Bucket &entry) {
+        std::size_t bucket = get_bucket(entry.hash);
+        while (!buckets[bucket].is_empty())
+            bucket = get_next_bucket(bucket);
+        buckets[bucket] = entry;
+    }
+
+    void grow() {
+        std::vector<Bucket> old_buckets = std::move(buckets);
+        buckets = std::vector<Bucket>(old_buckets.empty() ? MIN_CAPACITY : 2 * old_buckets.size());
+        for (const Bucket &entry : old_buckets)
+            if (!entry.is_empty())
+                insert_unique(entry);
+    }
+
+public:
+    IntHashSet(const Hasher &hasher, const Equal &equal)
+        : hasher(hasher),
+          equal(equal),
+          buckets(),
+          num_entries(0) {
+    }
+
+    int size() const {
+        return num_entries;
+    }
+
+    std::size_t capacity() const {
+        return buckets.size();
+    }
+
+    /*
+      Inserts the key if no equal key is contained. Returns the contained key
+      (the given key if it was inserted) and whether the key was inserted.
+    */
+    std::pair<KeyType, bool> insert(KeyType key) {
+        assert(key >= 0);
+        return insert_value(
+            hasher(key),
+            [this, key](KeyType other) {return equal(other, key);},
+            [key]() {return key;});
+    }
+
+    /*
+      Like insert, but for a value that does not have a key yet. The caller
+      passes the hash of the value (as the hash function would compute it for
+      its key) and a function that tests if a contained key is equal to the
+      value. Only if no such key is found, create_key is called to obtain the
+      key that is inserted. This way, the value only has to be stored
+      somewhere once we know that it is new.
+    */
+    template<typename ValueEqual, typename CreateKey>
+    std::pair<KeyType, bool> insert_value(
+        std::size_t value_hash, const ValueEqual &value_equal, const CreateKey &create_key) {
+        if (static_cast<std::size_t>(num_entries + 1) * MAX_LOAD_DENOMINATOR > buckets.size() * MAX_LOAD_NUMERATOR)
+            grow();
+        HashType hash = static_cast<HashType>(value_hash);
+        std::size_t bucket = get_bucket(hash);
+        while (!buckets[bucket].is_empty()) {
+            const Bucket &entry = buckets[bucket];
+            if (entry.hash == hash && value_equal(entry.key))
+                return std::make_pair(entry.key, false);
+            bucket = get_next_bucket(bucket);
+        }
+        KeyType key = create_key();
+        assert(key >= 0);
+        buckets[bucket] = Bucket(key, hash);
+        ++num_entries;
+        return std::make_pair(key, true);
+    }
+
+    std::size_t estimate_memory_usage() const {
+        return buckets.capacity() * sizeof(Bucket);
+    }
+};
+}
+
+#endif
@@ -74,6 +74,15 @@ void IntPacker::VariableInfo::init_zero(Bin *buffer) const {
 	bin = (bin & clear_mask);
 }
 
+auto IntPacker::VariableInfo::get_bits(const Bin *buffer) const -> Bin {
+	return (buffer[bin_index] & read_mask) >> shift;
+}
+
+void IntPacker::VariableInfo::set_bits(Bin *buffer, Bin bits) const {
+	Bin &bin = buffer[bin_index];
+	bin = (bin & clear_mask) | ((bits << shift) & read_mask);
+}
+
 IntPacker::IntPacker()
     : num_bins(0) {}
 
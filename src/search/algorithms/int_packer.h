@@ -59,6 +59,10 @@ protected:
 		bool get_bit(const Bin *buffer, int value) const;
 		void set_bit(Bin *buffer, int value) const;
 		void init_zero(Bin *buffer) const;
+
+		// all bits of the variable, shifted to the lowest bits of the result
+		auto get_bits(const Bin *buffer) const -> Bin;
+		void set_bits(Bin *buffer, Bin bits) const;
     };
 
     std::vector<VariableInfo> var_infos;
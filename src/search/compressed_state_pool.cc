@@ -0,0 +1,174 @@
+#include "compressed_state_pool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+using namespace std;
+
+constexpr int CompressedStatePool::BITS_PER_BIN;
+constexpr CompressedStatePool::Bin CompressedStatePool::NO_PARENT;
+constexpr int CompressedStatePool::MAX_CHAIN_LENGTH;
+constexpr int CompressedStatePool::BLOCK_SIZE;
+constexpr int CompressedStatePool::CACHE_SIZE;
+
+CompressedStatePool::CompressedStatePool(int bins_per_state)
+    : bins_per_state(bins_per_state),
+      mask_bins_per_state((bins_per_state + BITS_PER_BIN - 1) / BITS_PER_BIN),
+      num_states(0),
+      num_full_states(0),
+      buffers(1 + bins_per_state),
+      cache(CACHE_SIZE),
+      num_lookups(0),
+      num_cache_hits(0) {
+}
+
+size_t CompressedStatePool::get_record_position(int id) const {
+    size_t position = block_positions[id / BLOCK_SIZE];
+    for (int skipped_id = id - id % BLOCK_SIZE; skipped_id < id; ++skipped_id)
+        position += get_record_size(position);
+    return position;
+}
+
+int CompressedStatePool::get_record_size(size_t position) const {
+    if (records[position] == NO_PARENT)
+        return 1 + bins_per_state;
+    int size = 1 + mask_bins_per_state;
+    for (int i = 0; i < mask_bins_per_state; ++i)
+        for (Bin mask = records[position + 1 + i]; mask; mask &= mask - 1)
+            ++size;
+    return size;
+}
+
+void CompressedStatePool::push_back_full(const Bin *data) {
+    records.push_back(NO_PARENT);
+    for (int i = 0; i < bins_per_state; ++i)
+        records.push_back(data[i]);
+    ++num_full_states;
+}
+
+CompressedStatePool::Bin *CompressedStatePool::allocate_buffer() const {
+    Bin *buffer;
+    if (free_buffers.empty()) {
+        buffers.push_back(vector<Bin>(1 + bins_per_state, 0).data());
+        buffer = buffers[buffers.size() - 1];
+    } else {
+        buffer = free_buffers.back();
+        free_buffers.pop_back();
+    }
+    assert(buffer[0] == 0);
+    buffer[0] = 1;
+    return buffer + 1;
+}
+
+void CompressedStatePool::pin(const Bin *data) const {
+    Bin &num_pins = const_cast<Bin *>(data)[-1];
+    assert(num_pins > 0);
+    ++num_pins;
+}
+
+void CompressedStatePool::unpin(const Bin *data) const {
+    Bin &num_pins = const_cast<Bin *>(data)[-1];
+    assert(num_pins > 0);
+    if (--num_pins == 0)
+        free_buffers.push_back(&num_pins);
+}
+
+void CompressedStatePool::cache_state(int id, const Bin *data) const {
+    CacheEntry &entry = cache[id % CACHE_SIZE];
+    pin(data);
+    if (entry.data)
+        unpin(entry.data);
+    entry.id = id;
+    entry.data = data;
+}
+
+int CompressedStatePool::push_back(const Bin *data, int parent_id, const Bin *parent_data) {
+    if (num_states % BLOCK_SIZE == 0)
+        block_positions.push_back(records.size());
+    int chain_length = 0;
+    if (parent_id != -1 && chain_lengths[parent_id] < MAX_CHAIN_LENGTH) {
+        assert(parent_data);
+        int num_changed_bins = 0;
+        for (int i = 0; i < bins_per_state; ++i)
+            if (data[i] != parent_data[i])
+                ++num_changed_bins;
+        if (mask_bins_per_state + num_changed_bins < bins_per_state) {
+            chain_length = chain_lengths[parent_id] + 1;
+            records.push_back(static_cast<Bin>(parent_id));
+            size_t mask_position = records.size();
+            for (int i = 0; i < mask_bins_per_state; ++i)
+                records.push_back(0);
+            for (int i = 0; i < bins_per_state; ++i) {
+                if (data[i] != parent_data[i]) {
+                    records[mask_position + i / BITS_PER_BIN] |= Bin(1) << (i % BITS_PER_BIN);
+                    records.push_back(data[i]);
+                }
+            }
+        }
+    }
+    if (chain_length == 0)
+        push_back_full(data);
+    chain_lengths.push_back(chain_length);
+    int id = num_states++;
+    // The new state is usually looked up right away.
+    Bin *cached_data = allocate_buffer();
+    copy(data, data + bins_per_state, cached_data);
+    cache_state(id, cached_data);
+    unpin(cached_data);
+    return id;
+}
+
+const CompressedStatePool::Bin *CompressedStatePool::get(int id) const {
+    assert(id >= 0 && id < num_states);
+    ++num_lookups;
+    const CacheEntry &entry = cache[id % CACHE_SIZE];
+    if (entry.id == id) {
+        ++num_cache_hits;
+        pin(entry.data);
+        return entry.data;
+    }
+
+    // Follow the parents to a state that is cached or stored in full.
+    Bin *data = allocate_buffer();
+    delta_positions.clear();
+    for (int current_id = id;;) {
+        const CacheEntry &cached = cache[current_id % CACHE_SIZE];
+        if (cached.id == current_id) {
+            copy(cached.data, cached.data + bins_per_state, data);
+            break;
+        }
+        size_t position = get_record_position(current_id);
+        if (records[position] == NO_PARENT) {
+            for (int i = 0; i < bins_per_state; ++i)
+                data[i] = records[position + 1 + i];
+            break;
+        }
+        delta_positions.push_back(position);
+        current_id = records[position];
+    }
+
+    // Apply the deltas, starting with the one closest to that state.
+    for (auto it = delta_positions.rbegin(); it != delta_positions.rend(); ++it) {
+        size_t mask_position = *it + 1;
+        size_t value_position = mask_position + mask_bins_per_state;
+        for (int i = 0; i < bins_per_state; ++i)
+            if (records[mask_position + i / BITS_PER_BIN] & (Bin(1) << (i % BITS_PER_BIN)))
+                data[i] = records[value_position++];
+    }
+    cache_state(id, data);
+    return data;
+}
+
+size_t CompressedStatePool::estimate_memory_usage() const {
+    return records.size() * sizeof(Bin) +
+           block_positions.size() * sizeof(size_t) +
+           chain_lengths.size() * sizeof(uint8_t);
+}
+
+void CompressedStatePool::print_statistics() const {
+    cout << "Compressed states: " << num_states << " ("
+         << num_full_states << " stored in full)" << endl;
+    cout << "Compressed state lookups: " << num_lookups << " ("
+         << num_cache_hits << " cache hits)" << endl;
+}
@@ -0,0 +1,107 @@
+#ifndef COMPRESSED_STATE_POOL_H
+#define COMPRESSED_STATE_POOL_H
+
+#include "algorithms/int_packer.h"
+#include "algorithms/segmented_vector.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/*
+  CompressedStatePool stores the packed data of registered states in less
+  memory than a SegmentedArrayVector, at the cost of some time to restore it.
+
+  A state with a parent is stored as a delta to its parent: the parent's ID,
+  a bit mask of the bins that differ from the parent and the values of these
+  bins. States without a parent, states whose delta would not be smaller, and
+  every MAX_CHAIN_LENGTH-th state along a chain of deltas are stored in full.
+  This bounds the number of deltas that have to be applied to restore a state.
+
+  The records of all states are stored back to back. Since records differ in
+  size, the pool only remembers where every BLOCK_SIZE-th record starts and
+  skips over the records before the requested one within its block.
+
+  States are restored into buffers that belong to the pool. A buffer is
+  pinned while it is in use, i.e. while it is returned by get and not yet
+  unpinned, and is reused for other states once nothing pins it. The most
+  recently restored states are kept pinned in a small cache, which also
+  serves as the starting point for restoring their descendants.
+*/
+
+class CompressedStatePool {
+    using Bin = int_packer::IntPacker::Bin;
+
+    static constexpr int BITS_PER_BIN = std::numeric_limits<Bin>::digits;
+    static constexpr Bin NO_PARENT = std::numeric_limits<Bin>::max();
+    static constexpr int MAX_CHAIN_LENGTH = 8;
+    static constexpr int BLOCK_SIZE = 16;
+    static constexpr int CACHE_SIZE = 64;
+
+    struct CacheEntry {
+        int id;
+        const Bin *data;
+
+        CacheEntry()
+            : id(-1),
+              data(nullptr) {
+        }
+    };
+
+    const int bins_per_state;
+    const int mask_bins_per_state;
+
+    segmented_vector::SegmentedVector<Bin> records;
+    segmented_vector::SegmentedVector<std::size_t> block_positions;
+    // number of deltas on the way to the last state stored in full
+    segmented_vector::SegmentedVector<std::uint8_t> chain_lengths;
+    int num_states;
+    int num_full_states;
+
+    /*
+      Buffers for restored states. The first bin of each buffer holds the
+      number of pins, the state data follows.
+    */
+    mutable segmented_vector::SegmentedArrayVector<Bin> buffers;
+    mutable std::vector<Bin *> free_buffers;
+    mutable std::vector<CacheEntry> cache;
+    mutable std::vector<std::size_t> delta_positions;
+    mutable long long num_lookups;
+    mutable long long num_cache_hits;
+
+    std::size_t get_record_position(int id) const;
+    int get_record_size(std::size_t position) const;
+    void push_back_full(const Bin *data);
+    // Returns the data part of an unused buffer, pinned once.
+    Bin *allocate_buffer() const;
+    void cache_state(int id, const Bin *data) const;
+
+    // No implementation to forbid copies and assignment
+    CompressedStatePool(const CompressedStatePool &);
+    CompressedStatePool &operator=(const CompressedStatePool &);
+public:
+    explicit CompressedStatePool(int bins_per_state);
+
+    int size() const {
+        return num_states;
+    }
+
+    /*
+      Stores the data of a new state, relative to the given parent if
+      parent_id is not -1. Returns the ID of the new state.
+    */
+    int push_back(const Bin *data, int parent_id, const Bin *parent_data);
+
+    /*
+      Returns the data of the state with the given ID. The data is pinned
+      for the caller, who has to unpin it when it is no longer used.
+    */
+    const Bin *get(int id) const;
+    void pin(const Bin *data) const;
+    void unpin(const Bin *data) const;
+
+    std::size_t estimate_memory_usage() const;
+    void print_statistics() const;
+};
+
+#endif
@@ -23,10 +23,10 @@ protected:
         const PackedStateBin *buffer, const StateRegistryBase<GlobalState, GlobalOperator> &registry, StateID id);
 
 public:
-    virtual ~GlobalState() = default;
+    ~GlobalState() = default;
 
-    void dump_pddl() const override;
-    void dump_fdr() const override;
+    void dump_pddl() const;
+    void dump_fdr() const;
 };
 
 
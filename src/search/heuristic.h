@@ -77,6 +77,10 @@ protected:
     */
     void set_preferred(const OperatorProxy &op);
 
+    const ordered_set::OrderedSet<OperatorID> &get_preferred_operators() const {
+        return preferred_operators;
+    }
+
     /* TODO: Make private and use State instead of GlobalState once all
        heuristics use the TaskProxy class. */
     State convert_global_state(const StateType &global_state) const;
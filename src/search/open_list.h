@@ -92,6 +92,12 @@ public:
     */
     virtual void boost_preferred();
 
+    /*
+      Print statistics about the open list, e.g. its memory usage.
+      The default implementation does nothing.
+    */
+    virtual void print_statistics() const;
+
     /*
       Add all heuristics that this open lists uses (directly or
       indirectly) into the result set.
@@ -154,6 +160,10 @@ template<class Entry, class StateType, class OperatorType>
 void OpenList<Entry, StateType, OperatorType>::boost_preferred() {
 }
 
+template<class Entry, class StateType, class OperatorType>
+void OpenList<Entry, StateType, OperatorType>::print_statistics() const {
+}
+
 template<class Entry, class StateType, class OperatorType>
 void OpenList<Entry, StateType, OperatorType>::insert(
     EvaluationContext<StateType, OperatorType> &eval_context, const Entry &entry) {
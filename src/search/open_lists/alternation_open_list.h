@@ -25,6 +25,7 @@ public:
     virtual bool empty() const override;
     virtual void clear() override;
     virtual void boost_preferred() override;
+    virtual void print_statistics() const override;
     virtual void get_involved_heuristics(std::set<Heuristic<StateType, OperatorType> *> &hset) override;
     virtual bool is_dead_end(
         EvaluationContext<StateType, OperatorType> &eval_context) const override;
@@ -123,6 +124,12 @@ void AlternationOpenList<Entry, StateType, OperatorType>::boost_preferred() {
             priorities[i] -= boost_amount;
 }
 
+template<class Entry, class StateType, class OperatorType>
+void AlternationOpenList<Entry, StateType, OperatorType>::print_statistics() const {
+    for (const auto &sublist : open_lists)
+        sublist->print_statistics();
+}
+
 template<class Entry, class StateType, class OperatorType>
 void AlternationOpenList<Entry, StateType, OperatorType>::get_involved_heuristics(
     std::set<Heuristic<StateType, OperatorType> *> &hset) {
@@ -0,0 +1,162 @@
+#ifndef OPEN_LISTS_BUCKET_CHUNK_POOL_H
+#define OPEN_LISTS_BUCKET_CHUNK_POOL_H
+
+#include "../algorithms/segmented_vector.h"
+
+#include <cassert>
+#include <iostream>
+#include <new>
+#include <type_traits>
+
+/*
+  Storage for the FIFO buckets of an open list.
+
+  Instead of a std::deque per bucket, all buckets of an open list store
+  their entries in fixed-size chunks taken from one BucketChunkPool. A
+  ChunkedBucket is a linked list of chunks. Chunks that run empty are
+  put on a free list and reused by the next bucket that needs one, so
+  the number of allocations does not grow with the number of buckets
+  that are created and drained during the search. The memory of the
+  pool is only released when the open list is destroyed.
+
+  A ChunkedBucket does not know its pool, so all of its operations that
+  access the entries take the pool as an argument. Entries that are left
+  in the buckets when the pool is cleared or destroyed are not destructed,
+  which is fine for the entries of our open lists (state IDs and edges).
+*/
+
+namespace bucket_chunk_pool {
+template<class Entry>
+class ChunkedBucket;
+
+template<class Entry>
+class BucketChunkPool {
+    friend class ChunkedBucket<Entry>;
+
+    static const int CHUNK_SIZE = 32;
+    static const int NO_CHUNK = -1;
+
+    // Entries need not be default-constructible, so they are constructed in place.
+    struct Chunk {
+        typename std::aligned_storage<sizeof(Entry), alignof(Entry)>::type entries[CHUNK_SIZE];
+        int next;
+    };
+
+    segmented_vector::SegmentedVector<Chunk> chunks;
+    // first free chunk; the free chunks are linked by their next field
+    int free_chunk;
+
+    long long num_requests;
+    long long num_reused;
+
+    int allocate() {
+        ++num_requests;
+        int chunk;
+        if (free_chunk != NO_CHUNK) {
+            ++num_reused;
+            chunk = free_chunk;
+            free_chunk = chunks[chunk].next;
+        } else {
+            chunk = static_cast<int>(chunks.size());
+            chunks.push_back(Chunk());
+        }
+        chunks[chunk].next = NO_CHUNK;
+        return chunk;
+    }
+
+    void release(int chunk) {
+        chunks[chunk].next = free_chunk;
+        free_chunk = chunk;
+    }
+
+    Entry *get_entry(int chunk, int position) {
+        return reinterpret_cast<Entry *>(&chunks[chunk].entries[position]);
+    }
+
+    // No implementation to forbid copies and assignment
+    BucketChunkPool(const BucketChunkPool &);
+    BucketChunkPool &operator=(const BucketChunkPool &);
+public:
+    BucketChunkPool()
+        : free_chunk(NO_CHUNK),
+          num_requests(0),
+          num_reused(0) {
+    }
+
+    // Makes all chunks available again. Only valid if all buckets are discarded.
+    void clear() {
+        free_chunk = NO_CHUNK;
+        for (int chunk = static_cast<int>(chunks.size()) - 1; chunk >= 0; --chunk)
+            release(chunk);
+    }
+
+    // Since chunks are never given back, this is also the peak memory usage.
+    std::size_t estimate_memory_usage() const {
+        return chunks.size() * sizeof(Chunk);
+    }
+
+    void print_statistics() const {
+        std::cout << "Open list chunk requests: " << num_requests << " ("
+                  << num_reused << " served from the free list)" << std::endl;
+        std::cout << "Peak open list chunk memory: "
+                  << estimate_memory_usage() / 1024 << " KB" << std::endl;
+    }
+};
+
+
+template<class Entry>
+class ChunkedBucket {
+    using Pool = BucketChunkPool<Entry>;
+
+    int first_chunk;
+    int last_chunk;
+    // position of the first entry in first_chunk
+    int front;
+    // position after the last entry in last_chunk
+    int back;
+
+public:
+    ChunkedBucket()
+        : first_chunk(Pool::NO_CHUNK),
+          last_chunk(Pool::NO_CHUNK),
+          front(0),
+          back(0) {
+    }
+
+    bool empty() const {
+        return first_chunk == Pool::NO_CHUNK;
+    }
+
+    void push_back(Pool &pool, const Entry &entry) {
+        if (empty()) {
+            first_chunk = last_chunk = pool.allocate();
+            front = back = 0;
+        } else if (back == Pool::CHUNK_SIZE) {
+            int chunk = pool.allocate();
+            pool.chunks[last_chunk].next = chunk;
+            last_chunk = chunk;
+            back = 0;
+        }
+        new (pool.get_entry(last_chunk, back++)) Entry(entry);
+    }
+
+    Entry pop_front(Pool &pool) {
+        assert(!empty());
+        Entry *entry = pool.get_entry(first_chunk, front++);
+        Entry result = *entry;
+        entry->~Entry();
+        if (first_chunk == last_chunk && front == back) {
+            pool.release(first_chunk);
+            first_chunk = last_chunk = Pool::NO_CHUNK;
+        } else if (front == Pool::CHUNK_SIZE) {
+            int next = pool.chunks[first_chunk].next;
+            pool.release(first_chunk);
+            first_chunk = next;
+            front = 0;
+        }
+        return result;
+    }
+};
+}
+
+#endif
@@ -0,0 +1,52 @@
+#include "bucket_open_list.h"
+
+#include "../open_list.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+using namespace std;
+
+namespace bucket_open_list {
+static shared_ptr<OpenListFactory<GlobalState, GlobalOperator>> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Bucket open list",
+        "Like the standard open list, but stores the buckets in an array "
+        "indexed by the evaluator value. Intended for evaluators with a "
+        "small range of values.");
+    parser.add_option<Evaluator<GlobalState, GlobalOperator> *>("eval", "evaluator");
+    parser.add_option<bool>(
+        "pref_only",
+        "insert only nodes generated by preferred operators", "false");
+
+    Options opts = parser.parse();
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<BucketOpenListFactory<GlobalState, GlobalOperator>>(opts);
+}
+
+static shared_ptr<OpenListFactory<GlobalState, GlobalOperator>> _parse_tiebreaking(OptionParser &parser) {
+    parser.document_synopsis(
+        "Tie-breaking bucket open list",
+        "Like the tie-breaking open list, but stores the buckets for the "
+        "first evaluator in an array indexed by its value.");
+    parser.add_list_option<Evaluator<GlobalState, GlobalOperator> *>("evals", "evaluators");
+    parser.add_option<bool>(
+        "pref_only",
+        "insert only nodes generated by preferred operators", "false");
+    parser.add_option<bool>(
+        "unsafe_pruning",
+        "allow unsafe pruning when the main evaluator regards a state a dead end",
+        "true");
+    Options opts = parser.parse();
+    opts.verify_list_non_empty<Evaluator<GlobalState, GlobalOperator> *>("evals");
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<TieBreakingBucketOpenListFactory<GlobalState, GlobalOperator>>(opts);
+}
+
+static PluginShared<OpenListFactory<GlobalState, GlobalOperator>> _plugin("bucket", _parse);
+static PluginShared<OpenListFactory<GlobalState, GlobalOperator>> _plugin_tiebreaking(
+    "tiebreaking_bucket", _parse_tiebreaking);
+}
@@ -0,0 +1,434 @@
+#ifndef OPEN_LISTS_BUCKET_OPEN_LIST_H
+#define OPEN_LISTS_BUCKET_OPEN_LIST_H
+
+#include "../open_list_factory.h"
+#include "../option_parser_util.h"
+
+#include "bucket_chunk_pool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+
+/*
+  Open lists that order their entries like StandardScalarOpenList and
+  TieBreakingOpenList (FIFO tie-breaking), but store the buckets for the
+  (first) key in an array instead of a map. Like there, the buckets store
+  their entries in chunks from a pool (see bucket_chunk_pool.h).
+
+  The array is indexed by the offset of the key to the start of the key
+  range seen so far, and the position of the first non-empty bucket is
+  cached. Similar to AdaptiveQueue (see algorithms/priority_queues.h),
+  the buckets are moved to a map if the key range becomes large compared
+  to the number of insertions.
+*/
+
+namespace bucket_open_list {
+template<class Bucket>
+class BucketArray {
+    static const int MIN_BUCKETS_BEFORE_SWITCH = 10000;
+
+    // buckets[i] holds the entries with key first_key + i
+    std::vector<Bucket> buckets;
+    int first_key;
+    // there are no non-empty buckets before min_index
+    mutable int min_index;
+    long long num_insertions;
+
+    bool use_map;
+    std::map<int, Bucket> sparse_buckets;
+
+    void update_min_index() const {
+        assert(!use_map);
+        while (buckets[min_index].empty())
+            ++min_index;
+        assert(min_index < static_cast<int>(buckets.size()));
+    }
+
+    void switch_to_map() {
+        for (std::size_t i = 0; i < buckets.size(); ++i)
+            if (!buckets[i].empty())
+                sparse_buckets.emplace(first_key + static_cast<int>(i), std::move(buckets[i]));
+        std::vector<Bucket>().swap(buckets);
+        use_map = true;
+    }
+
+    void extend_range(int key) {
+        std::int64_t end = static_cast<std::int64_t>(first_key) + buckets.size();
+        std::int64_t needed_range = std::max<std::int64_t>(end, static_cast<std::int64_t>(key) + 1) -
+            std::min(first_key, key);
+        if (needed_range > MIN_BUCKETS_BEFORE_SWITCH && needed_range > num_insertions) {
+            switch_to_map();
+            return;
+        }
+        if (key < first_key) {
+            // Leave room for smaller keys to avoid shifting the buckets every time.
+            std::int64_t new_first_key = std::min<std::int64_t>(
+                key, std::max<std::int64_t>(first_key - static_cast<std::int64_t>(buckets.size()), 0));
+            int shift = first_key - static_cast<int>(new_first_key);
+            std::vector<Bucket> new_buckets(end - new_first_key);
+            std::move(buckets.begin(), buckets.end(), new_buckets.begin() + shift);
+            buckets.swap(new_buckets);
+            first_key = static_cast<int>(new_first_key);
+            min_index += shift;
+        } else {
+            buckets.resize(key - first_key + 1);
+        }
+    }
+
+public:
+    BucketArray()
+        : first_key(0),
+          min_index(0),
+          num_insertions(0),
+          use_map(false) {
+    }
+
+    // Returns the bucket for inserting an entry with the given key.
+    Bucket &get_bucket(int key) {
+        ++num_insertions;
+        if (!use_map && buckets.empty()) {
+            first_key = key;
+            min_index = 0;
+        }
+        if (!use_map && (key < first_key ||
+                         static_cast<std::int64_t>(key) - first_key >= static_cast<std::int64_t>(buckets.size())))
+            extend_range(key);
+        if (use_map)
+            return sparse_buckets[key];
+        int index = key - first_key;
+        min_index = std::min(min_index, index);
+        return buckets[index];
+    }
+
+    // The following methods require that some bucket is non-empty.
+    int get_min_key() const {
+        if (use_map)
+            return sparse_buckets.begin()->first;
+        update_min_index();
+        return first_key + min_index;
+    }
+
+    Bucket &get_min_bucket() {
+        if (use_map)
+            return sparse_buckets.begin()->second;
+        update_min_index();
+        return buckets[min_index];
+    }
+
+    // Call after removing an entry from the bucket returned by get_min_bucket.
+    void remove_min_bucket_if_empty() {
+        if (use_map && sparse_buckets.begin()->second.empty())
+            sparse_buckets.erase(sparse_buckets.begin());
+    }
+
+    void clear() {
+        buckets.clear();
+        sparse_buckets.clear();
+        first_key = 0;
+        min_index = 0;
+        num_insertions = 0;
+        use_map = false;
+    }
+};
+
+
+template<class Entry, class StateType, class OperatorType>
+class BucketOpenList : public OpenList<Entry, StateType, OperatorType> {
+    typedef bucket_chunk_pool::ChunkedBucket<Entry> Bucket;
+
+    bucket_chunk_pool::BucketChunkPool<Entry> chunk_pool;
+    BucketArray<Bucket> buckets;
+    int size;
+
+    Evaluator<StateType, OperatorType> *evaluator;
+
+protected:
+    virtual void do_insertion(EvaluationContext<StateType, OperatorType> &eval_context,
+                              const Entry &entry) override;
+
+public:
+    explicit BucketOpenList(const Options &opts);
+    virtual ~BucketOpenList() override = default;
+
+    virtual Entry remove_min(std::vector<int> *key = nullptr) override;
+    auto get_min_key() const -> int override;
+    auto is_min_preferred() const -> bool override;
+    virtual bool empty() const override;
+    virtual void clear() override;
+    virtual void print_statistics() const override;
+    virtual void get_involved_heuristics(std::set<Heuristic<StateType, OperatorType> *> &hset) override;
+    virtual bool is_dead_end(
+        EvaluationContext<StateType, OperatorType> &eval_context) const override;
+    virtual bool is_reliable_dead_end(
+        EvaluationContext<StateType, OperatorType> &eval_context) const override;
+};
+
+template<class Entry, class StateType, class OperatorType>
+BucketOpenList<Entry, StateType, OperatorType>::BucketOpenList(const Options &opts)
+    : OpenList<Entry, StateType, OperatorType>(opts.get<bool>("pref_only")),
+      size(0),
+      evaluator(opts.get<Evaluator<StateType, OperatorType> *>("eval")) {
+}
+
+template<class Entry, class StateType, class OperatorType>
+void BucketOpenList<Entry, StateType, OperatorType>::do_insertion(
+    EvaluationContext<StateType, OperatorType> &eval_context, const Entry &entry) {
+    int key = eval_context.get_heuristic_value(evaluator);
+    buckets.get_bucket(key).push_back(chunk_pool, entry);
+    ++size;
+}
+
+template<class Entry, class StateType, class OperatorType>
+Entry BucketOpenList<Entry, StateType, OperatorType>::remove_min(std::vector<int> *key) {
+    assert(size > 0);
+    if (key) {
+        assert(key->empty());
+        key->push_back(buckets.get_min_key());
+    }
+    Entry result = buckets.get_min_bucket().pop_front(chunk_pool);
+    buckets.remove_min_bucket_if_empty();
+    --size;
+    return result;
+}
+
+template<class Entry, class StateType, class OperatorType>
+auto BucketOpenList<Entry, StateType, OperatorType>::get_min_key() const -> int {
+    assert(size > 0);
+    return buckets.get_min_key();
+}
+
+template<class Entry, class StateType, class OperatorType>
+auto BucketOpenList<Entry, StateType, OperatorType>::is_min_preferred() const -> bool {
+    assert(size > 0);
+    return this->only_contains_preferred_entries();
+}
+
+template<class Entry, class StateType, class OperatorType>
+bool BucketOpenList<Entry, StateType, OperatorType>::empty() const {
+    return size == 0;
+}
+
+template<class Entry, class StateType, class OperatorType>
+void BucketOpenList<Entry, StateType, OperatorType>::clear() {
+    buckets.clear();
+    chunk_pool.clear();
+    size = 0;
+}
+
+template<class Entry, class StateType, class OperatorType>
+void BucketOpenList<Entry, StateType, OperatorType>::print_statistics() const {
+    chunk_pool.print_statistics();
+}
+
+template<class Entry, class StateType, class OperatorType>
+void BucketOpenList<Entry, StateType, OperatorType>::get_involved_heuristics(
+    std::set<Heuristic<StateType, OperatorType> *> &hset) {
+    evaluator->get_involved_heuristics(hset);
+}
+
+template<class Entry, class StateType, class OperatorType>
+bool BucketOpenList<Entry, StateType, OperatorType>::is_dead_end(
+    EvaluationContext<StateType, OperatorType> &eval_context) const {
+    return eval_context.is_heuristic_infinite(evaluator);
+}
+
+template<class Entry, class StateType, class OperatorType>
+bool BucketOpenList<Entry, StateType, OperatorType>::is_reliable_dead_end(
+    EvaluationContext<StateType, OperatorType> &eval_context) const {
+    return is_dead_end(eval_context) && evaluator->dead_ends_are_reliable();
+}
+
+
+/*
+  The first key selects the bucket in the array, the remaining keys (if
+  any) are ordered by a map within that bucket.
+*/
+template<class Entry, class StateType, class OperatorType>
+class TieBreakingBucketOpenList : public OpenList<Entry, StateType, OperatorType> {
+    typedef bucket_chunk_pool::ChunkedBucket<Entry> Bucket;
+    typedef std::map<std::vector<int>, Bucket> SecondaryBuckets;
+
+    bucket_chunk_pool::BucketChunkPool<Entry> chunk_pool;
+    BucketArray<SecondaryBuckets> buckets;
+    int size;
+
+    std::vector<Evaluator<StateType, OperatorType> *> evaluators;
+    /*
+      If allow_unsafe_pruning is true, we ignore (don't insert) states
+      which the first evaluator considers a dead end, even if it is
+      not a safe heuristic.
+    */
+    bool allow_unsafe_pruning;
+
+protected:
+    virtual void do_insertion(EvaluationContext<StateType, OperatorType> &eval_context,
+                              const Entry &entry) override;
+
+public:
+    explicit TieBreakingBucketOpenList(const Options &opts);
+    virtual ~TieBreakingBucketOpenList() override = default;
+
+    virtual Entry remove_min(std::vector<int> *key = nullptr) override;
+    virtual bool empty() const override;
+    virtual void clear() override;
+    virtual void print_statistics() const override;
+    virtual void get_involved_heuristics(std::set<Heuristic<StateType, OperatorType> *> &hset) override;
+    virtual bool is_dead_end(
+        EvaluationContext<StateType, OperatorType> &eval_context) const override;
+    virtual bool is_reliable_dead_end(
+        EvaluationContext<StateType, OperatorType> &eval_context) const override;
+};
+
+template<class Entry, class StateType, class OperatorType>
+TieBreakingBucketOpenList<Entry, StateType, OperatorType>::TieBreakingBucketOpenList(const Options &opts)
+    : OpenList<Entry, StateType, OperatorType>(opts.get<bool>("pref_only")),
+      size(0),
+      evaluators(opts.get_list<Evaluator<StateType, OperatorType> *>("evals")),
+      allow_unsafe_pruning(opts.get<bool>("unsafe_pruning")) {
+}
+
+template<class Entry, class StateType, class OperatorType>
+void TieBreakingBucketOpenList<Entry, StateType, OperatorType>::do_insertion(
+    EvaluationContext<StateType, OperatorType> &eval_context, const Entry &entry) {
+    int first_key = eval_context.get_heuristic_value_or_infinity(evaluators[0]);
+    std::vector<int> secondary_key;
+    secondary_key.reserve(evaluators.size() - 1);
+    for (std::size_t i = 1; i < evaluators.size(); ++i)
+        secondary_key.push_back(eval_context.get_heuristic_value_or_infinity(evaluators[i]));
+    buckets.get_bucket(first_key)[secondary_key].push_back(chunk_pool, entry);
+    ++size;
+}
+
+template<class Entry, class StateType, class OperatorType>
+Entry TieBreakingBucketOpenList<Entry, StateType, OperatorType>::remove_min(std::vector<int> *key) {
+    assert(size > 0);
+    if (key) {
+        assert(key->empty());
+        key->push_back(buckets.get_min_key());
+    }
+    SecondaryBuckets &secondary_buckets = buckets.get_min_bucket();
+    auto it = secondary_buckets.begin();
+    assert(it != secondary_buckets.end());
+    if (key)
+        key->insert(key->end(), it->first.begin(), it->first.end());
+    Entry result = it->second.pop_front(chunk_pool);
+    if (it->second.empty())
+        secondary_buckets.erase(it);
+    buckets.remove_min_bucket_if_empty();
+    --size;
+    return result;
+}
+
+template<class Entry, class StateType, class OperatorType>
+bool TieBreakingBucketOpenList<Entry, StateType, OperatorType>::empty() const {
+    return size == 0;
+}
+
+template<class Entry, class StateType, class OperatorType>
+void TieBreakingBucketOpenList<Entry, StateType, OperatorType>::clear() {
+    buckets.clear();
+    chunk_pool.clear();
+    size = 0;
+}
+
+template<class Entry, class StateType, class OperatorType>
+void TieBreakingBucketOpenList<Entry, StateType, OperatorType>::print_statistics() const {
+    chunk_pool.print_statistics();
+}
+
+template<class Entry, class StateType, class OperatorType>
+void TieBreakingBucketOpenList<Entry, StateType, OperatorType>::get_involved_heuristics(
+    std::set<Heuristic<StateType, OperatorType> *> &hset) {
+    for (Evaluator<StateType, OperatorType> *evaluator : evaluators)
+        evaluator->get_involved_heuristics(hset);
+}
+
+template<class Entry, class StateType, class OperatorType>
+bool TieBreakingBucketOpenList<Entry, StateType, OperatorType>::is_dead_end(
+    EvaluationContext<StateType, OperatorType> &eval_context) const {
+    // Same behaviour as TieBreakingOpenList::is_dead_end.
+    if (is_reliable_dead_end(eval_context))
+        return true;
+    if (allow_unsafe_pruning &&
+        eval_context.is_heuristic_infinite(evaluators[0]))
+        return true;
+    for (Evaluator<StateType, OperatorType> *evaluator : evaluators)
+        if (!eval_context.is_heuristic_infinite(evaluator))
+            return false;
+    return true;
+}
+
+template<class Entry, class StateType, class OperatorType>
+bool TieBreakingBucketOpenList<Entry, StateType, OperatorType>::is_reliable_dead_end(
+    EvaluationContext<StateType, OperatorType> &eval_context) const {
+    for (Evaluator<StateType, OperatorType> *evaluator : evaluators)
+        if (eval_context.is_heuristic_infinite(evaluator) &&
+            evaluator->dead_ends_are_reliable())
+            return true;
+    return false;
+}
+
+
+template<class StateType, class OperatorType>
+class BucketOpenListFactory : public OpenListFactory<StateType, OperatorType> {
+    Options options;
+public:
+    explicit BucketOpenListFactory(const Options &options);
+    virtual ~BucketOpenListFactory() override = default;
+
+    virtual std::unique_ptr<StateOpenList<StateType, OperatorType>> create_state_open_list() override;
+    virtual std::unique_ptr<EdgeOpenList<StateType, OperatorType>> create_edge_open_list() override;
+};
+
+template<class StateType, class OperatorType>
+BucketOpenListFactory<StateType, OperatorType>::BucketOpenListFactory(const Options &options)
+    : options(options) {
+}
+
+template<class StateType, class OperatorType>
+std::unique_ptr<StateOpenList<StateType, OperatorType>>
+BucketOpenListFactory<StateType, OperatorType>::create_state_open_list() {
+    return utils::make_unique_ptr<BucketOpenList<StateOpenListEntry, StateType, OperatorType>>(options);
+}
+
+template<class StateType, class OperatorType>
+std::unique_ptr<EdgeOpenList<StateType, OperatorType>>
+BucketOpenListFactory<StateType, OperatorType>::create_edge_open_list() {
+    return utils::make_unique_ptr<BucketOpenList<EdgeOpenListEntry, StateType, OperatorType>>(options);
+}
+
+
+template<class StateType, class OperatorType>
+class TieBreakingBucketOpenListFactory : public OpenListFactory<StateType, OperatorType> {
+    Options options;
+public:
+    explicit TieBreakingBucketOpenListFactory(const Options &options);
+    virtual ~TieBreakingBucketOpenListFactory() override = default;
+
+    virtual std::unique_ptr<StateOpenList<StateType, OperatorType>> create_state_open_list() override;
+    virtual std::unique_ptr<EdgeOpenList<StateType, OperatorType>> create_edge_open_list() override;
+};
+
+template<class StateType, class OperatorType>
+TieBreakingBucketOpenListFactory<StateType, OperatorType>::TieBreakingBucketOpenListFactory(const Options &options)
+    : options(options) {
+}
+
+template<class StateType, class OperatorType>
+std::unique_ptr<StateOpenList<StateType, OperatorType>>
+TieBreakingBucketOpenListFactory<StateType, OperatorType>::create_state_open_list() {
+    return utils::make_unique_ptr<TieBreakingBucketOpenList<StateOpenListEntry, StateType, OperatorType>>(options);
+}
+
+template<class StateType, class OperatorType>
+std::unique_ptr<EdgeOpenList<StateType, OperatorType>>
+TieBreakingBucketOpenListFactory<StateType, OperatorType>::create_edge_open_list() {
+    return utils::make_unique_ptr<TieBreakingBucketOpenList<EdgeOpenListEntry, StateType, OperatorType>>(options);
+}
+}
+
+#endif
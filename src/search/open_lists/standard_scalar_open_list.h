@@ -4,18 +4,22 @@
 #include "../open_list_factory.h"
 #include "../option_parser_util.h"
 
+#include "bucket_chunk_pool.h"
+
 
 /*
   Open list indexed by a single int, using FIFO tie-breaking.
 
-  Implemented as a map from int to deques.
+  Implemented as a map from int to buckets, which store their entries in
+  chunks from a pool shared by all buckets (see bucket_chunk_pool.h).
 */
 
 namespace standard_scalar_open_list {
 template<class Entry, class StateType, class OperatorType>
 class StandardScalarOpenList : public OpenList<Entry, StateType, OperatorType> {
-    typedef std::deque<Entry> Bucket;
+    typedef bucket_chunk_pool::ChunkedBucket<Entry> Bucket;
 
+    bucket_chunk_pool::BucketChunkPool<Entry> chunk_pool;
     std::map<int, Bucket> buckets;
     int size;
 
@@ -35,6 +39,7 @@ public:
 	auto is_min_preferred() const -> bool override;
     virtual bool empty() const override;
     virtual void clear() override;
+    virtual void print_statistics() const override;
     virtual void get_involved_heuristics(std::set<Heuristic<StateType, OperatorType> *> &hset) override;
     virtual bool is_dead_end(
         EvaluationContext<StateType, OperatorType> &eval_context) const override;
@@ -61,7 +66,7 @@ template<class Entry, class StateType, class OperatorType>
 void StandardScalarOpenList<Entry, StateType, OperatorType>::do_insertion(
     EvaluationContext<StateType, OperatorType> &eval_context, const Entry &entry) {
     int key = eval_context.get_heuristic_value(evaluator);
-    buckets[key].push_back(entry);
+    buckets[key].push_back(chunk_pool, entry);
     ++size;
 }
 
@@ -77,8 +82,7 @@ Entry StandardScalarOpenList<Entry, StateType, OperatorType>::remove_min(std::ve
 
     Bucket &bucket = it->second;
     assert(!bucket.empty());
-    Entry result = bucket.front();
-    bucket.pop_front();
+    Entry result = bucket.pop_front(chunk_pool);
     if (bucket.empty())
         buckets.erase(it);
     --size;
@@ -107,9 +111,15 @@ bool StandardScalarOpenList<Entry, StateType, OperatorType>::empty() const {
 template<class Entry, class StateType, class OperatorType>
 void StandardScalarOpenList<Entry, StateType, OperatorType>::clear() {
     buckets.clear();
+    chunk_pool.clear();
     size = 0;
 }
 
+template<class Entry, class StateType, class OperatorType>
+void StandardScalarOpenList<Entry, StateType, OperatorType>::print_statistics() const {
+    chunk_pool.print_statistics();
+}
+
 template<class Entry, class StateType, class OperatorType>
 void StandardScalarOpenList<Entry, StateType, OperatorType>::get_involved_heuristics(
     std::set<Heuristic<StateType, OperatorType> *> &hset) {
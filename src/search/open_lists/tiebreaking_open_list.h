@@ -4,11 +4,14 @@
 #include "../open_list_factory.h"
 #include "../option_parser_util.h"
 
+#include "bucket_chunk_pool.h"
+
 namespace tiebreaking_open_list {
 template<class Entry, class StateType, class OperatorType>
 class TieBreakingOpenList : public OpenList<Entry> {
-    using Bucket = std::deque<Entry>;
+    using Bucket = bucket_chunk_pool::ChunkedBucket<Entry>;
 
+    bucket_chunk_pool::BucketChunkPool<Entry> chunk_pool;
 	std::map<const std::vector<int>, Bucket> buckets;
     int size;
 
@@ -33,6 +36,7 @@ public:
     virtual Entry remove_min(std::vector<int> *key = nullptr) override;
     virtual bool empty() const override;
     virtual void clear() override;
+    virtual void print_statistics() const override;
     virtual void get_involved_heuristics(std::set<Heuristic<StateType, OperatorType> *> &hset) override;
     virtual bool is_dead_end(
         EvaluationContext<StateType, OperatorType> &eval_context) const override;
@@ -56,7 +60,7 @@ void TieBreakingOpenList<Entry, StateType, OperatorType>::do_insertion(
     for (Evaluator<StateType, OperatorType> *evaluator : evaluators)
         key.push_back(eval_context.get_heuristic_value_or_infinity(evaluator));
 
-    buckets[key].push_back(entry);
+    buckets[key].push_back(chunk_pool, entry);
     ++size;
 }
 
@@ -72,8 +76,7 @@ Entry TieBreakingOpenList<Entry, StateType, OperatorType>::remove_min(std::vecto
         assert(key->empty());
         *key = it->first;
     }
-    Entry result = it->second.front();
-    it->second.pop_front();
+    Entry result = it->second.pop_front(chunk_pool);
     if (it->second.empty())
         buckets.erase(it);
     return result;
@@ -87,9 +90,15 @@ bool TieBreakingOpenList<Entry, StateType, OperatorType>::empty() const {
 template<class Entry, class StateType, class OperatorType>
 void TieBreakingOpenList<Entry, StateType, OperatorType>::clear() {
     buckets.clear();
+    chunk_pool.clear();
     size = 0;
 }
 
+template<class Entry, class StateType, class OperatorType>
+void TieBreakingOpenList<Entry, StateType, OperatorType>::print_statistics() const {
+    chunk_pool.print_statistics();
+}
+
 template<class Entry, class StateType, class OperatorType>
 int TieBreakingOpenList<Entry, StateType, OperatorType>::dimension() const {
     return evaluators.size();
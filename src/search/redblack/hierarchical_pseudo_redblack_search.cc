@@ -1,13 +1,23 @@
 #include "hierarchical_pseudo_redblack_search.h"
 
 #include "search_space.h"
+#include "shared_task_data.h"
 #include "util.h"
+#include "../globals.h"
 #include "../search_engine.h"
+#include "../options/bounds.h"
 #include "../options/option_parser.h"
 #include "../search_engines/lazy_search.h"
 #include "../search_engines/search_common.h"
+#include "../task_utils/causal_graph.h"
+#include "../utils/rng.h"
+#include "../utils/rng_options.h"
 #include "incremental_painting_strategy.h"
 
+#include <mutex>
+#include <sstream>
+#include <thread>
+
 
 namespace redblack {
 
@@ -20,15 +30,118 @@ void verify_black_variable_values(const RBState &rb_state, const GlobalState &gl
 void verify_black_variable_values(const RBState &, const GlobalState &) {}
 #endif
 
+// the plan repair heuristic is shared by the root search and all workers
+static std::mutex plan_repair_mutex;
+
+/*
+  Stream buffer that is installed for std::cout when the child searches are advanced by several workers. The
+  output of a thread that collects its output (see set_thread_output) goes to the thread's buffer, so that the
+  main thread can write it in a deterministic order, everything else is passed on to the original buffer.
+*/
+class ThreadOutputBuffer : public std::streambuf {
+	std::ostream &stream;
+	std::streambuf *const output;
+	static thread_local std::streambuf *thread_output;
+
+	auto get_output() const -> std::streambuf * {
+		return thread_output ? thread_output : output;
+	}
+
+protected:
+	auto overflow(int_type c) -> int_type override {
+		if (traits_type::eq_int_type(c, traits_type::eof()))
+			return traits_type::not_eof(c);
+		return get_output()->sputc(traits_type::to_char_type(c));
+	}
+
+	auto xsputn(const char *s, std::streamsize n) -> std::streamsize override {
+		return get_output()->sputn(s, n);
+	}
+
+	auto sync() -> int override {
+		return get_output()->pubsync();
+	}
+
+public:
+	explicit ThreadOutputBuffer(std::ostream &stream) : stream(stream), output(stream.rdbuf()) {
+		stream.rdbuf(this);
+	}
+
+	~ThreadOutputBuffer() override {
+		stream.rdbuf(output);
+	}
+
+	// nullptr passes the output of the calling thread on to the original buffer again
+	static void set_thread_output(std::streambuf *buffer) {
+		thread_output = buffer;
+	}
+};
+
+thread_local std::streambuf *ThreadOutputBuffer::thread_output = nullptr;
+
+void HierarchicalPseudoRedBlackSearchStatistics::add(const HierarchicalPseudoRedBlackSearchStatistics &other) {
+	num_openend_searches += other.num_openend_searches;
+	num_distinct_paintings += other.num_distinct_paintings;
+	num_failed_incomplete_searches += other.num_failed_incomplete_searches;
+	max_num_black = std::max(max_num_black, other.max_num_black);
+	total_num_evaluations += other.total_num_evaluations;
+	painting_setup_time += other.painting_setup_time;
+	painting_setup_bytes += other.painting_setup_bytes;
+	num_evicted_paintings += other.num_evicted_paintings;
+	num_recreated_paintings += other.num_recreated_paintings;
+	evicted_bytes += other.evicted_bytes;
+	evicted_applicable_ops_time += other.evicted_applicable_ops_time;
+}
+
+HierarchicalPseudoRedBlackSearchWorker::HierarchicalPseudoRedBlackSearchWorker(const options::Options &search_options,
+                                                                               std::shared_ptr<utils::RandomNumberGenerator> rng)
+	: search_options(search_options),
+	  global_state_registry(*g_root_task(), *g_state_packer, *g_axiom_evaluator, g_initial_state_data, search_options.get<bool>("compress_states")),
+	  global_search_space(global_state_registry, static_cast<OperatorCost>(search_options.get_enum("cost_type"))),
+	  root_states(),
+	  painting_registry(),
+	  rb_search_spaces(),
+	  rng(rng),
+	  statistics(),
+	  search_statistics() {}
+
+auto HierarchicalPseudoRedBlackSearchWorker::import_root_state(const GlobalState &root_state) -> GlobalState {
+	auto state = global_state_registry.import_state(root_state);
+	// imported states are the roots of the worker's global search space, the plan is completed with the path to them in the root search
+	auto node = global_search_space.get_node(state);
+	if (node.is_new()) {
+		node.open_initial();
+		node.close();
+	}
+	root_states.emplace(state.get_id(), root_state.get_id());
+	return state;
+}
+
+void HierarchicalPseudoRedBlackSearchWorker::collect_statistics(HierarchicalPseudoRedBlackSearchStatistics &root_statistics, SearchStatistics &root_search_statistics) {
+	root_statistics.add(statistics);
+	statistics = HierarchicalPseudoRedBlackSearchStatistics();
+	root_search_statistics.inc_expanded(search_statistics.get_expanded());
+	root_search_statistics.inc_evaluated_states(search_statistics.get_evaluated_states());
+	root_search_statistics.inc_evaluations(search_statistics.get_evaluations());
+	root_search_statistics.inc_generated(search_statistics.get_generated());
+	root_search_statistics.inc_reopened(search_statistics.get_reopened());
+	root_search_statistics.inc_generated_ops(search_statistics.get_generated_ops());
+	root_search_statistics.inc_dead_ends(search_statistics.get_dead_ends());
+	search_statistics = SearchStatistics();
+}
+
 HierarchicalPseudoRedBlackSearch::HierarchicalPseudoRedBlackSearch(const options::Options &opts,
                                                        std::shared_ptr<RBStateRegistry> state_registry,
                                                        std::shared_ptr<SearchSpace<RBState, RBOperator>> search_space,
+                                                       std::shared_ptr<CorrespondingGlobalStates> corresponding_global_state,
                                                        GlobalState current_initial_state,
                                                        StateRegistryBase<GlobalState, GlobalOperator> &global_state_registry,
                                                        SearchSpace<GlobalState, GlobalOperator> &global_search_space,
-                                                       std::map<InternalPaintingType, std::tuple<std::shared_ptr<RBData>, std::shared_ptr<RBStateRegistry>, std::shared_ptr<RedActionsManager>, std::shared_ptr<SearchSpace<RBState, RBOperator>>>> &rb_search_spaces,
+                                                       PaintingRegistry &painting_registry,
+                                                       std::vector<PaintingData> &rb_search_spaces,
                                                        std::shared_ptr<RedBlackDAGFactFollowingHeuristic> plan_repair_heuristic,
                                                        std::shared_ptr<RedActionsManager> red_actions_manager,
+                                                       std::shared_ptr<utils::RandomNumberGenerator> rng,
                                                        const std::vector<bool> &never_black_variables,
                                                        HierarchicalPseudoRedBlackSearchStatistics &hierarchical_red_black_search_statistics,
                                                        SearchStatistics &global_search_statistics,
@@ -38,14 +151,20 @@ HierarchicalPseudoRedBlackSearch::HierarchicalPseudoRedBlackSearch(const options
 	: LazySearch<RBState, RBOperator>(opts, state_registry, search_space),
 	  plan_repair_heuristic(plan_repair_heuristic),
 	  red_actions_manager(red_actions_manager),
+	  rng(rng),
 	  never_black_variables(never_black_variables),
 	  is_current_preferred(initial_state_is_preferred),
 	  current_key(initial_state_h_value),
 	  child_searches(),
 	  current_child_search(nullptr),
 	  current_child_search_index(-1),
+	  workers(nullptr),
+	  worker(nullptr),
+	  num_worker_searches(0),
+	  goal_worker(nullptr),
+	  pending_open_list_entry(),
 	  current_best_supporters(static_cast<RBStateRegistry *>(this->state_registry.get())->get_initial_state_best_supporters()),
-	  corresponding_global_state(),
+	  corresponding_global_state(corresponding_global_state),
 	  current_global_state(current_initial_state),
 	  global_goal_state(StateID::no_state),
 	  search_options(opts),
@@ -53,6 +172,7 @@ HierarchicalPseudoRedBlackSearch::HierarchicalPseudoRedBlackSearch(const options
 	  current_initial_state(current_initial_state),
 	  global_state_registry(global_state_registry),
 	  global_search_space(global_search_space),
+	  painting_registry(painting_registry),
 	  rb_search_spaces(rb_search_spaces),
 	  num_black(num_black),
 	  force_completeness(opts.get<bool>("force_completeness")),
@@ -61,7 +181,6 @@ HierarchicalPseudoRedBlackSearch::HierarchicalPseudoRedBlackSearch(const options
 	auto pref_operator_heuristics = search_options.get_list<Heuristic<RBState, RBOperator> *>("preferred");
 	set_pref_operator_heuristics(pref_operator_heuristics);
 	LazySearch<RBState, RBOperator>::initialize();
-	corresponding_global_state.insert({current_state.get_id(), current_initial_state.get_id()});
 	// auto _num_black = std::count_if(
 	// 	std::begin(static_cast<RBStateRegistry *>(this->state_registry.get())->get_painting().get_painting()),
 	// 	std::end(static_cast<RBStateRegistry *>(this->state_registry.get())->get_painting().get_painting()),
@@ -74,7 +193,22 @@ HierarchicalPseudoRedBlackSearch::HierarchicalPseudoRedBlackSearch(const options
 }
 
 
-auto get_random_new_painting(const Painting &last_painting, int num_black) -> Painting {
+auto create_painting_data(const Painting &painting, const std::vector<int> &initial_state_data, const options::Options &opts,
+                          bool create_red_actions_manager, HierarchicalPseudoRedBlackSearchStatistics &statistics) -> PaintingData {
+	auto setup_timer = utils::Timer();
+	auto rb_data = std::make_shared<RBData>(painting);
+	auto state_registry = std::shared_ptr<RBStateRegistry>(rb_data->construct_state_registry(initial_state_data, get_state_saturation_type(opts), opts.get<bool>("incremental_saturation"), opts.get<bool>("compress_states"), opts.get<bool>("time_applicable_ops")));
+	auto red_actions_manager = create_red_actions_manager ? std::make_shared<RedActionsManager>(state_registry->get_operators()) : nullptr;
+	auto search_space = std::make_shared<SearchSpace<RBState, RBOperator>>(*state_registry, static_cast<OperatorCost>(opts.get_enum("cost_type")));
+	auto corresponding_global_state = std::make_shared<CorrespondingGlobalStates>(StateID::no_state);
+	statistics.painting_setup_time += setup_timer();
+	statistics.painting_setup_bytes += state_registry->estimate_painting_data_memory_usage();
+	if (red_actions_manager)
+		statistics.painting_setup_bytes += red_actions_manager->estimate_memory_usage();
+	return {rb_data, state_registry, red_actions_manager, search_space, corresponding_global_state};
+}
+
+auto get_random_new_painting(const Painting &last_painting, int num_black, utils::RandomNumberGenerator &rng) -> Painting {
 	assert(!std::all_of(std::begin(last_painting.get_painting()), std::end(last_painting.get_painting()), [](const auto is_red) { return !is_red; }));
 	auto red_variables = std::vector<std::size_t>();
 	red_variables.reserve(g_root_task()->get_num_variables());
@@ -82,9 +216,7 @@ auto get_random_new_painting(const Painting &last_painting, int num_black) -> Pa
 		if (last_painting.is_red_var(i))
 			red_variables.push_back(i);
 	assert(!red_variables.empty());
-	std::random_device rd;
-	std::mt19937 g(rd());
-	std::shuffle(std::begin(red_variables), std::end(red_variables), g);
+	rng.shuffle(red_variables);
 	auto next_painting = last_painting.get_painting();
 	for (auto i = 0u; i < std::min<std::size_t>(red_variables.size(), num_black); ++i)
 		next_painting[red_variables[i]] = false;
@@ -92,33 +224,43 @@ auto get_random_new_painting(const Painting &last_painting, int num_black) -> Pa
 }
 
 void HierarchicalPseudoRedBlackSearch::enqueue_new_search(const Painting &painting, const GlobalState &initial_state, int key, bool preferred, EvaluationContext<RBState, RBOperator> &new_eval_context) {
+	// the child searches of the root search are distributed among the workers, all other searches use the data of their parent
+	auto *child_worker = workers ? (*workers)[num_worker_searches++ % workers->size()].get() : nullptr;
+	auto &child_painting_registry = child_worker ? child_worker->painting_registry : painting_registry;
+	auto &child_rb_search_spaces = child_worker ? child_worker->rb_search_spaces : rb_search_spaces;
+	const auto &child_search_options = child_worker ? child_worker->search_options : search_options;
+	const auto child_initial_state = child_worker ? child_worker->import_root_state(initial_state) : initial_state;
 	++hierarchical_red_black_search_statistics.num_openend_searches;
-	auto rb_search_space_it = rb_search_spaces.find(painting.get_painting());
+	const auto [painting_id, painting_is_registered] = child_painting_registry.insert(painting.get_painting());
 	auto painting_is_new = false;
-	if (rb_search_space_it == std::end(rb_search_spaces)) {
-		auto new_rb_data = std::make_shared<RBData>(painting);
-		auto new_state_registry = std::shared_ptr<RBStateRegistry>(new_rb_data->construct_state_registry(initial_state.get_values()));
-		auto new_red_actions_manager = plan_repair_heuristic ? std::make_shared<RedActionsManager>(new_state_registry->get_operators()) : nullptr;
-		auto new_search_space = std::make_shared<SearchSpace<RBState, RBOperator>>(*new_state_registry, static_cast<OperatorCost>(search_options.get_enum("cost_type")));
-		rb_search_space_it = rb_search_spaces.insert({painting.get_painting(), {new_rb_data, new_state_registry, new_red_actions_manager, new_search_space}}).first;
+	if (painting_is_registered) {
+		assert(painting_id == static_cast<int>(child_rb_search_spaces.size()));
+		child_rb_search_spaces.push_back(create_painting_data(painting, initial_state.get_values(), child_search_options, plan_repair_heuristic != nullptr, hierarchical_red_black_search_statistics));
 		painting_is_new = true;
 		++hierarchical_red_black_search_statistics.num_distinct_paintings;
 		hierarchical_red_black_search_statistics.max_num_black = std::max(painting.count_num_black(), hierarchical_red_black_search_statistics.max_num_black);
+	} else if (!std::get<std::shared_ptr<RBStateRegistry>>(child_rb_search_spaces[painting_id])) {
+		// the data of this painting was evicted, set it up again
+		child_rb_search_spaces[painting_id] = create_painting_data(painting, initial_state.get_values(), child_search_options, plan_repair_heuristic != nullptr, hierarchical_red_black_search_statistics);
+		painting_is_new = true;
+		++hierarchical_red_black_search_statistics.num_recreated_paintings;
 	}
 	assert(!initial_state.get_values().empty());
-	assert(rb_search_space_it != std::end(rb_search_spaces));
+	const auto &painting_data = child_rb_search_spaces[painting_id];
 	child_searches[current_state.get_id()].emplace_back(std::make_unique<HierarchicalPseudoRedBlackSearch>(
-		search_options, std::get<1>(rb_search_space_it->second), std::get<3>(rb_search_space_it->second),
-		initial_state, global_state_registry, global_search_space, rb_search_spaces, plan_repair_heuristic,
-		std::get<std::shared_ptr<RedActionsManager>>(rb_search_space_it->second),
-		never_black_variables, hierarchical_red_black_search_statistics, global_search_statistics, num_black, preferred, key));
+		child_search_options, std::get<1>(painting_data), std::get<3>(painting_data),
+		std::get<std::shared_ptr<CorrespondingGlobalStates>>(painting_data), child_initial_state,
+		child_worker ? child_worker->global_state_registry : global_state_registry, child_worker ? child_worker->global_search_space : global_search_space,
+		child_painting_registry, child_rb_search_spaces, plan_repair_heuristic,
+		std::get<std::shared_ptr<RedActionsManager>>(painting_data), child_worker ? child_worker->rng : rng, never_black_variables,
+		child_worker ? child_worker->statistics : hierarchical_red_black_search_statistics, child_worker ? child_worker->search_statistics : global_search_statistics,
+		num_black, preferred, key));
+	auto &child_search = *child_searches.at(current_state.get_id()).back();
+	child_search.worker = child_worker;
 	if (!painting_is_new) {
 		// state registry initial state doesn't match the actual initial state that should be used in the search
-		auto &child_search = *child_searches.at(current_state.get_id()).back();
-		std::tie(child_search.current_state, child_search.current_best_supporters) = std::get<1>(rb_search_space_it->second)->get_state_and_best_supporters(initial_state.get_values());
+		std::tie(child_search.current_state, child_search.current_best_supporters) = std::get<1>(painting_data)->get_state_and_best_supporters(initial_state.get_values());
 		child_search.current_eval_context = EvaluationContext<RBState, RBOperator>(child_search.current_state, 0, true, &child_search.statistics);
-		child_search.corresponding_global_state.clear();
-		child_search.corresponding_global_state.insert({child_search.current_state.get_id(), initial_state.get_id()});
 	}
 	assert(!child_searches.at(current_state.get_id()).empty());
 	open_list->insert(new_eval_context, {current_state.get_id(), -static_cast<int>(child_searches.at(current_state.get_id()).size() - 1) - 1});
@@ -144,43 +286,9 @@ SearchStatus HierarchicalPseudoRedBlackSearch::step() {
 
 	if (current_child_search) {
 		assert(*current_child_search);
-		auto result = (**current_child_search).step();
-		switch (result) {
-		case SOLVED:
-			global_goal_state = (**current_child_search).get_goal_state();
-			return SOLVED;
-		case FAILED: {
-			const auto &painting = static_cast<RBStateRegistry *>((**current_child_search).state_registry.get())->get_painting().get_painting();
-			if (!force_completeness || std::none_of(std::begin(painting), std::end(painting), [](const auto is_red) { return is_red; })) {
-				// all black painting ==> search space exhausted below this child search's initial state
-				current_child_search->reset();
-				break;
-			}
-			// no plan to search conflicts in ...
-			auto new_painting = get_random_new_painting(painting, num_black);
-			++hierarchical_red_black_search_statistics.num_failed_incomplete_searches;
-			// insert this child search into the open list, using the current state's key as the new key as well
-			assert(*current_child_search);
-			auto new_eval_context = EvaluationContext<RBState, RBOperator>(get_hacked_cache_for_key(current_key), current_g, is_current_preferred, nullptr);
-			enqueue_new_search(new_painting, (**current_child_search).current_initial_state, current_key, is_current_preferred, new_eval_context);
-			// Note: enqueue_new_search invalidates the current_child_search pointer
-			child_searches[current_state.get_id()][current_child_search_index].reset();
-			break;
-		}
-		case TIMEOUT:
-			return TIMEOUT;
-		case IN_PROGRESS: {
-			// reinsert this "state" into the open list, using the key of the current search node from the child search
-			auto hacked_eval_context = EvaluationContext<RBState, RBOperator>(get_hacked_cache_for_key((**current_child_search).get_current_key()), current_g, is_current_preferred, nullptr);
-			assert(current_child_search_index >= 0);
-			//std::cout << "continuing child search after having done a step in child search" << std::endl;
-			open_list->insert(hacked_eval_context, {current_predecessor_id, -current_child_search_index - 1});
-			break;
-		}
-		default:
-			assert(false && "unreachable");
-			utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
-		}
+		const auto status = workers ? step_child_searches_concurrently() : handle_child_search_result((**current_child_search).step());
+		if (status != IN_PROGRESS)
+			return status;
 	} else {
 		//std::cout << "doing step in search " << this << ": expanding node with parent " << current_predecessor_id << " and operator " << current_operator << std::endl;
 		auto node = search_space->get_node(current_state);
@@ -200,6 +308,7 @@ SearchStatus HierarchicalPseudoRedBlackSearch::step() {
 					heuristic->notify_state_transition(
 						parent_state, *current_operator, current_state);
 			}
+			(*corresponding_global_state)[current_state] = current_global_state.get_id();
 			statistics.inc_evaluated_states();
 			global_search_statistics.inc_evaluated_states();
 			++hierarchical_red_black_search_statistics.total_num_evaluations;
@@ -220,8 +329,7 @@ SearchStatus HierarchicalPseudoRedBlackSearch::step() {
 				}
 				node.close();
 				if (test_goal(current_state)) {
-					assert(corresponding_global_state.find(current_state.get_id()) != std::end(corresponding_global_state));
-					assert(corresponding_global_state.at(current_state.get_id()) == current_global_state.get_id());
+					assert((*corresponding_global_state)[current_state] == current_global_state.get_id());
 					verify_black_variable_values(current_state, current_global_state);
 					assert(global_search_space.get_node(current_global_state).is_closed());
 					auto goal_facts = std::vector<FactPair>();
@@ -268,13 +376,133 @@ SearchStatus HierarchicalPseudoRedBlackSearch::step() {
 	return fetch_next_state();
 }
 
+auto HierarchicalPseudoRedBlackSearch::handle_child_search_result(SearchStatus result) -> SearchStatus {
+	switch (result) {
+	case SOLVED:
+		global_goal_state = (**current_child_search).get_goal_state();
+		goal_worker = (**current_child_search).worker;
+		return SOLVED;
+	case FAILED: {
+		const auto &painting = static_cast<RBStateRegistry *>((**current_child_search).state_registry.get())->get_painting().get_painting();
+		if (!force_completeness || std::none_of(std::begin(painting), std::end(painting), [](const auto is_red) { return is_red; })) {
+			// all black painting ==> search space exhausted below this child search's initial state
+			current_child_search->reset();
+			break;
+		}
+		// no plan to search conflicts in ...
+		auto new_painting = get_random_new_painting(painting, num_black, *rng);
+		++hierarchical_red_black_search_statistics.num_failed_incomplete_searches;
+		// insert this child search into the open list, using the current state's key as the new key as well
+		assert(*current_child_search);
+		auto new_eval_context = EvaluationContext<RBState, RBOperator>(get_hacked_cache_for_key(current_key), current_g, is_current_preferred, nullptr);
+		auto initial_state = (**current_child_search).current_initial_state;
+		if ((**current_child_search).worker)
+			// the initial state is in the global state registry of the child search's worker
+			initial_state = global_state_registry.import_state(initial_state);
+		enqueue_new_search(new_painting, initial_state, current_key, is_current_preferred, new_eval_context);
+		// Note: enqueue_new_search invalidates the current_child_search pointer
+		child_searches[current_state.get_id()][current_child_search_index].reset();
+		break;
+	}
+	case TIMEOUT:
+		return TIMEOUT;
+	case IN_PROGRESS: {
+		// reinsert this "state" into the open list, using the key of the current search node from the child search
+		auto hacked_eval_context = EvaluationContext<RBState, RBOperator>(get_hacked_cache_for_key((**current_child_search).get_current_key()), current_g, is_current_preferred, nullptr);
+		assert(current_child_search_index >= 0);
+		//std::cout << "continuing child search after having done a step in child search" << std::endl;
+		open_list->insert(hacked_eval_context, {current_predecessor_id, -current_child_search_index - 1});
+		break;
+	}
+	default:
+		assert(false && "unreachable");
+		utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+	}
+	return IN_PROGRESS;
+}
+
+auto HierarchicalPseudoRedBlackSearch::step_child_searches_concurrently() -> SearchStatus {
+	struct ChildSearchEntry {
+		StateID predecessor_id;
+		int index;
+		int key;
+		bool preferred;
+		HierarchicalPseudoRedBlackSearch *search;
+	};
+	// the current child search and the child searches that follow it in the open list, at most one per worker
+	auto batch = std::vector<ChildSearchEntry>{{current_predecessor_id, current_child_search_index, current_key, is_current_preferred, current_child_search->get()}};
+	auto is_worker_used = [&batch](const auto *worker) {
+		return std::any_of(std::begin(batch), std::end(batch), [worker](const auto &entry) { return entry.search->worker == worker; });
+	};
+	assert(!pending_open_list_entry);
+	while (batch.size() < workers->size() && !open_list->empty()) {
+		const auto preferred = open_list->is_min_preferred();
+		const auto key = open_list->get_min_key();
+		const auto next = open_list->remove_min();
+		if (next.second < 0) {
+			const auto &child_search = child_searches.at(next.first)[-next.second - 1];
+			if (!child_search)
+				// this open list entry was already handled, see fetch_next_state
+				continue;
+			if (!is_worker_used(child_search->worker)) {
+				batch.push_back({next.first, -next.second - 1, key, preferred, child_search.get()});
+				continue;
+			}
+		}
+		// the entry is not part of this batch, it is handled next (putting it back into the open list would move it
+		// behind the entries with the same key and, with several open lists, insert it into all of them again)
+		pending_open_list_entry.emplace(next, key, preferred);
+		break;
+	}
+
+	// the child searches only use the data of their worker, so they can do their steps concurrently
+	auto results = std::vector<SearchStatus>(batch.size(), IN_PROGRESS);
+	auto outputs = std::vector<std::stringbuf>(batch.size());
+	auto run_child_search = [&batch, &results, &outputs](int i) {
+		ThreadOutputBuffer::set_thread_output(&outputs[i]);
+		for (auto steps = 0; steps < CHILD_SEARCH_STEPS_PER_BATCH && results[i] == IN_PROGRESS; ++steps)
+			results[i] = batch[i].search->step();
+		ThreadOutputBuffer::set_thread_output(nullptr);
+	};
+	auto threads = std::vector<std::thread>();
+	threads.reserve(batch.size() - 1);
+	for (auto i = 1; i < static_cast<int>(batch.size()); ++i)
+		threads.emplace_back(run_child_search, i);
+	run_child_search(0);
+	for (auto &thread : threads)
+		thread.join();
+	for (const auto &output : outputs)
+		std::cout << output.str();
+	std::cout.flush();
+	for (auto &worker : *workers)
+		worker->collect_statistics(hierarchical_red_black_search_statistics, global_search_statistics);
+
+	// handle the results in the order in which the child searches were taken from the open list, so the search is deterministic
+	for (auto i = 0u; i < batch.size(); ++i) {
+		const auto &entry = batch[i];
+		current_predecessor_id = entry.predecessor_id;
+		current_child_search_index = entry.index;
+		current_child_search = &child_searches.at(entry.predecessor_id)[entry.index];
+		current_key = entry.key;
+		is_current_preferred = entry.preferred;
+		current_state = state_registry->lookup_state(entry.predecessor_id);
+		auto current_node = search_space->get_node(current_state);
+		current_g = current_node.get_g();
+		current_real_g = current_node.get_real_g();
+		const auto status = handle_child_search_result(results[i]);
+		if (status != IN_PROGRESS)
+			return status;
+	}
+	return IN_PROGRESS;
+}
+
 auto HierarchicalPseudoRedBlackSearch::realizability_check(const RBState &state, const RBOperator &op) -> bool{
 	const auto &preconditions = op.get_base_operator().get_preconditions();
 	auto precondition_facts = std::vector<FactPair>();
 	precondition_facts.reserve(preconditions.size());
 	std::transform(std::begin(preconditions), std::end(preconditions), std::back_inserter(precondition_facts), [](const auto &condition) { return FactPair{ condition.var, condition.val }; });
-	assert(corresponding_global_state.find(state.get_id()) != std::end(corresponding_global_state));
-	auto global_state = global_state_registry.lookup_state(corresponding_global_state.at(state.get_id()));
+	assert((*corresponding_global_state)[state] != StateID::no_state);
+	auto global_state = global_state_registry.lookup_state((*corresponding_global_state)[state]);
 	verify_black_variable_values(state, global_state);
 	assert(global_search_space.get_node(global_state).is_closed());
 
@@ -310,53 +538,64 @@ auto HierarchicalPseudoRedBlackSearch::realizability_check(const RBState &state,
 }
 
 SearchStatus HierarchicalPseudoRedBlackSearch::fetch_next_state() {
-	if (open_list->empty()) {
-		std::cout << "Completely explored state space -- no solution!" << std::endl;
-		return FAILED;
-	}
-
-	is_current_preferred = open_list->is_min_preferred();
-	current_key = open_list->get_min_key();
-	auto next = open_list->remove_min();
-
-	current_predecessor_id = next.first;
-	assert(current_predecessor_id != StateID::no_state);
-	if (next.second < 0) {
-		assert(child_searches.find(current_predecessor_id) != std::end(child_searches));
-		current_child_search_index = -next.second - 1;
-		assert(static_cast<int>(child_searches.find(current_predecessor_id)->second.size()) > current_child_search_index);
-		current_child_search = &child_searches.find(current_predecessor_id)->second[current_child_search_index];
-		if (!*current_child_search)
-			// this open list entry was already handled (this can happen e.g. with the alternating queue, where entries are inserted in two different queues)
-			return fetch_next_state();
-		current_operator = nullptr;
-		// the members set below are probably not relevant for the child search case
-		current_state = state_registry->lookup_state(current_predecessor_id);
-		auto current_node = search_space->get_node(current_state);
-		current_g = current_node.get_g();
-		current_real_g = current_node.get_real_g();
-	} else {
-		current_child_search = nullptr;
-		current_operator = get_operator(next.second);
-		auto current_predecessor = state_registry->lookup_state(current_predecessor_id);
-		assert(current_operator->is_applicable(current_predecessor));
-		// TODO: make sure to not do work twice (i.e. for state/op pairs that have already been explored)
-		if (!realizability_check(current_predecessor, *current_operator))
-			return fetch_next_state();
-		std::tie(current_state, current_best_supporters) =
-			static_cast<RBStateRegistry *>(state_registry.get())->get_state_and_best_supporters(current_global_state.get_values());
-		corresponding_global_state.insert({current_state.get_id(), current_global_state.get_id()});
-		verify_black_variable_values(current_state, current_global_state);
-		auto pred_node = search_space->get_node(current_predecessor);
-		current_g = pred_node.get_g() + get_adjusted_cost(*current_operator);
-		current_real_g = pred_node.get_real_g() + current_operator->get_cost();
+	// skipped entries are handled iteratively, there can be too many of them in a row for recursive calls
+	while (true) {
+		if (!pending_open_list_entry) {
+			if (open_list->empty()) {
+				std::cout << "Completely explored state space -- no solution!" << std::endl;
+				return FAILED;
+			}
+			const auto preferred = open_list->is_min_preferred();
+			const auto key = open_list->get_min_key();
+			pending_open_list_entry.emplace(open_list->remove_min(), key, preferred);
+		}
+		const auto next = std::get<EdgeOpenListEntry>(*pending_open_list_entry);
+		current_key = std::get<int>(*pending_open_list_entry);
+		is_current_preferred = std::get<bool>(*pending_open_list_entry);
+		pending_open_list_entry.reset();
+
+		current_predecessor_id = next.first;
+		assert(current_predecessor_id != StateID::no_state);
+		if (next.second < 0) {
+			assert(child_searches.find(current_predecessor_id) != std::end(child_searches));
+			current_child_search_index = -next.second - 1;
+			assert(static_cast<int>(child_searches.find(current_predecessor_id)->second.size()) > current_child_search_index);
+			current_child_search = &child_searches.find(current_predecessor_id)->second[current_child_search_index];
+			if (!*current_child_search)
+				// this open list entry was already handled (this can happen e.g. with the alternating queue, where entries are inserted in two different queues)
+				continue;
+			current_operator = nullptr;
+			// the members set below are probably not relevant for the child search case
+			current_state = state_registry->lookup_state(current_predecessor_id);
+			auto current_node = search_space->get_node(current_state);
+			current_g = current_node.get_g();
+			current_real_g = current_node.get_real_g();
+		} else {
+			current_child_search = nullptr;
+			current_operator = get_operator(next.second);
+			auto current_predecessor = state_registry->lookup_state(current_predecessor_id);
+			assert(current_operator->is_applicable(current_predecessor));
+			// TODO: make sure to not do work twice (i.e. for state/op pairs that have already been explored)
+			if (!realizability_check(current_predecessor, *current_operator))
+				continue;
+			std::tie(current_state, current_best_supporters) =
+				static_cast<RBStateRegistry *>(state_registry.get())->get_state_and_best_supporters(current_global_state.get_values());
+			verify_black_variable_values(current_state, current_global_state);
+			auto pred_node = search_space->get_node(current_predecessor);
+			current_g = pred_node.get_g() + get_adjusted_cost(*current_operator);
+			current_real_g = pred_node.get_real_g() + current_operator->get_cost();
+		}
+		current_eval_context = EvaluationContext<RBState, RBOperator>(current_state, current_g, true, &statistics);
+		return IN_PROGRESS;
 	}
-	current_eval_context = EvaluationContext<RBState, RBOperator>(current_state, current_g, true, &statistics);
-	return IN_PROGRESS;
 }
 
 SearchStatus HierarchicalPseudoRedBlackSearchWrapper::step() {
 	auto status = root_search_engine->step();
+	if (max_painting_memory != -1 && ++steps_since_eviction_check == EVICTION_CHECK_INTERVAL) {
+		evict_paintings();
+		steps_since_eviction_check = 0;
+	}
 	// periodically print red black search statistics
 	if (statistics_interval != -1 && search_timer() > next_print_time) {
 		print_rb_search_statistics();
@@ -364,11 +603,94 @@ SearchStatus HierarchicalPseudoRedBlackSearchWrapper::step() {
 	}
 	if (status != SOLVED)
 		return status;
-	assert(test_goal(state_registry->lookup_state(root_search_engine->get_goal_state())));
-	check_goal_and_set_plan(state_registry->lookup_state(root_search_engine->get_goal_state()));
+	const auto *goal_worker = root_search_engine->get_goal_worker();
+	if (!goal_worker) {
+		assert(test_goal(state_registry->lookup_state(root_search_engine->get_goal_state())));
+		check_goal_and_set_plan(state_registry->lookup_state(root_search_engine->get_goal_state()));
+		return SOLVED;
+	}
+	// the plan leads to the initial state of a child search of the root search, and from there to the goal in the worker's search space
+	const auto goal_state = goal_worker->global_state_registry.lookup_state(root_search_engine->get_goal_state());
+	assert(test_goal(goal_state));
+	const auto root_state = state_registry->lookup_state(goal_worker->root_states.at(goal_worker->global_search_space.get_path_start(goal_state)));
+	auto plan = Plan();
+	search_space->trace_path(root_state, plan);
+	auto worker_plan = Plan();
+	goal_worker->global_search_space.trace_path(goal_state, worker_plan);
+	plan.insert(std::end(plan), std::begin(worker_plan), std::end(worker_plan));
+	std::cout << "Solution found!" << std::endl;
+	set_plan(plan);
 	return SOLVED;
 }
 
+auto estimate_painting_memory_usage(const PaintingData &painting_data) -> std::size_t {
+	const auto &[rb_data, state_registry, red_actions_manager, search_space, corresponding_global_state] = painting_data;
+	if (!state_registry)
+		return 0;
+	return state_registry->estimate_painting_data_memory_usage()
+		+ state_registry->estimate_state_memory_usage()
+		+ state_registry->size() * (sizeof(SearchNodeInfo) + sizeof(StateID))
+		+ (red_actions_manager ? red_actions_manager->estimate_memory_usage() : 0);
+}
+
+auto HierarchicalPseudoRedBlackSearchWrapper::estimate_painting_memory_usage() const -> std::size_t {
+	auto bytes = std::size_t{0};
+	for (const auto &painting_data : rb_search_spaces)
+		bytes += redblack::estimate_painting_memory_usage(painting_data);
+	for (const auto &worker : workers)
+		for (const auto &painting_data : worker->rb_search_spaces)
+			bytes += redblack::estimate_painting_memory_usage(painting_data);
+	return bytes;
+}
+
+auto HierarchicalPseudoRedBlackSearchWrapper::get_num_paintings() const -> std::size_t {
+	auto num_paintings = rb_search_spaces.size();
+	for (const auto &worker : workers)
+		num_paintings += worker->rb_search_spaces.size();
+	return num_paintings;
+}
+
+void HierarchicalPseudoRedBlackSearchWrapper::evict_paintings() {
+	const auto budget = static_cast<std::size_t>(max_painting_memory) * 1024 * 1024;
+	auto total_bytes = std::size_t{0};
+	// paintings that are not used by any unfinished search
+	auto unused_paintings = std::vector<std::pair<std::size_t, PaintingData *>>();
+	auto add_paintings = [&total_bytes, &unused_paintings](std::vector<PaintingData> &rb_search_spaces) {
+		for (auto &painting_data : rb_search_spaces) {
+			auto &[rb_data, state_registry, red_actions_manager, search_space, corresponding_global_state] = painting_data;
+			if (!state_registry)
+				continue;
+			const auto bytes = redblack::estimate_painting_memory_usage(painting_data);
+			total_bytes += bytes;
+			if (state_registry.use_count() == 1 && search_space.use_count() == 1 && corresponding_global_state.use_count() == 1
+				&& (!red_actions_manager || red_actions_manager.use_count() == 1))
+				unused_paintings.emplace_back(bytes, &painting_data);
+		}
+	};
+	add_paintings(rb_search_spaces);
+	for (auto &worker : workers)
+		add_paintings(worker->rb_search_spaces);
+	if (total_bytes <= budget)
+		return;
+	// evict the largest unused paintings first; the plan is reconstructed from the global search space, so nothing is lost but the duplicate detection within the painting
+	std::sort(std::begin(unused_paintings), std::end(unused_paintings), [](const auto &lhs, const auto &rhs) { return lhs.first > rhs.first; });
+	for (auto &[bytes, painting_data] : unused_paintings) {
+		if (total_bytes <= budget)
+			break;
+		auto &[rb_data, state_registry, red_actions_manager, search_space, corresponding_global_state] = *painting_data;
+		// release in reverse order of construction, the search space and registry reference the data of the painting
+		corresponding_global_state.reset();
+		search_space.reset();
+		red_actions_manager.reset();
+		hierarchical_red_black_search_statistics.evicted_applicable_ops_time += state_registry->get_applicable_ops_time();
+		state_registry.reset();
+		rb_data.reset();
+		total_bytes -= bytes;
+		++hierarchical_red_black_search_statistics.num_evicted_paintings;
+		hierarchical_red_black_search_statistics.evicted_bytes += bytes;
+	}
+}
+
 void HierarchicalPseudoRedBlackSearchWrapper::print_rb_search_statistics() const {
 	std::cout << "Number of openend searches: " << hierarchical_red_black_search_statistics.num_openend_searches << std::endl;
 	std::cout << "Number of distinct paintings: " << hierarchical_red_black_search_statistics.num_distinct_paintings << std::endl;
@@ -377,6 +699,32 @@ void HierarchicalPseudoRedBlackSearchWrapper::print_rb_search_statistics() const
 		<< " (" << hierarchical_red_black_search_statistics.max_num_black / static_cast<double>(g_root_task()->get_num_variables()) << "%)" << std::endl;
 	std::cout << "Number of evaluated states across all searches: " << hierarchical_red_black_search_statistics.total_num_evaluations << std::endl;
 	std::cout << "Average evaluations per search: " << hierarchical_red_black_search_statistics.total_num_evaluations / static_cast<double>(hierarchical_red_black_search_statistics.num_openend_searches) << std::endl;
+	std::cout << "Painting setup time: " << hierarchical_red_black_search_statistics.painting_setup_time << "s"
+		<< " (" << hierarchical_red_black_search_statistics.painting_setup_time / get_num_paintings() << "s per painting)" << std::endl;
+	std::cout << "Painting setup memory: " << hierarchical_red_black_search_statistics.painting_setup_bytes / 1024 << " KB"
+		<< " (" << hierarchical_red_black_search_statistics.painting_setup_bytes / get_num_paintings() << " bytes per painting)" << std::endl;
+	std::cout << "Shared painting-independent data: " << SharedTaskData::get().estimate_memory_usage() / 1024 << " KB" << std::endl;
+	std::cout << "Estimated memory of all paintings: " << estimate_painting_memory_usage() / 1024 << " KB";
+	if (max_painting_memory != -1)
+		std::cout << " (budget: " << max_painting_memory << " MB)";
+	std::cout << std::endl;
+	std::cout << "Number of evicted paintings: " << hierarchical_red_black_search_statistics.num_evicted_paintings
+		<< " (" << hierarchical_red_black_search_statistics.evicted_bytes / 1024 << " KB)" << std::endl;
+	std::cout << "Number of re-created evicted paintings: " << hierarchical_red_black_search_statistics.num_recreated_paintings << std::endl;
+	if (time_applicable_ops) {
+		auto applicable_ops_time = hierarchical_red_black_search_statistics.evicted_applicable_ops_time;
+		for (const auto &painting_data : rb_search_spaces)
+			if (const auto &state_registry = std::get<std::shared_ptr<RBStateRegistry>>(painting_data))
+				applicable_ops_time += state_registry->get_applicable_ops_time();
+		for (const auto &worker : workers)
+			for (const auto &painting_data : worker->rb_search_spaces)
+				if (const auto &state_registry = std::get<std::shared_ptr<RBStateRegistry>>(painting_data))
+					applicable_ops_time += state_registry->get_applicable_ops_time();
+		std::cout << "Applicable operator generation time: " << applicable_ops_time << "s"
+			<< " (" << applicable_ops_time / hierarchical_red_black_search_statistics.num_distinct_paintings << "s per painting)" << std::endl;
+	}
+	if (plan_repair_heuristic)
+		print_semi_relaxed_plan_statistics(*plan_repair_heuristic);
 }
 
 void HierarchicalPseudoRedBlackSearchWrapper::print_statistics() const {
@@ -435,7 +783,9 @@ auto HierarchicalPseudoRedBlackSearch::get_repaired_plan(const GlobalState &stat
 		}
 	}
 #endif
-	auto result = plan_repair_heuristic->compute_semi_relaxed_plan(state, goal_facts, plan, red_actions_manager.get()->get_red_actions_for_state(state));
+	const auto legal_operators = red_actions_manager.get()->get_red_actions_for_state(state);
+	auto lock = std::lock_guard<std::mutex>(plan_repair_mutex);
+	auto result = plan_repair_heuristic->compute_semi_relaxed_plan(state, goal_facts, plan, legal_operators);
 #ifndef NDEBUG
 	assert(!result.first || std::all_of(std::begin(result.second), std::end(result.second), [&red_actions](const auto &op_id) { return red_actions[op_id.get_index()]; }));
 #endif
@@ -474,30 +824,97 @@ auto HierarchicalPseudoRedBlackSearch::get_goal_state() const -> StateID {
 	return global_goal_state;
 }
 
+auto HierarchicalPseudoRedBlackSearch::get_goal_worker() const -> const HierarchicalPseudoRedBlackSearchWorker * {
+	return goal_worker;
+}
+
+void HierarchicalPseudoRedBlackSearch::set_workers(std::vector<std::unique_ptr<HierarchicalPseudoRedBlackSearchWorker>> &workers) {
+	this->workers = &workers;
+}
+
+static const std::string DEFAULT_HEURISTIC = "ff_rb(transform=adapt_costs(cost_type=1))";
+static const std::string DEFAULT_INCREMENTAL_PAINTING_STRATEGY = "least_conflicts()";
+
+// parses the argument with the given keyword of the search configuration again, or the default value if it is not given
+template<class T>
+static auto parse_argument(const options::ParseTree &config, const std::string &key, const std::string &default_value) -> T {
+	for (auto argument = options::first_child_of_root(config); argument != options::end_of_roots_children(config); ++argument) {
+		if (argument->key == key) {
+			options::OptionParser parser(options::subtree(config, argument), false);
+			return parser.start_parsing<T>();
+		}
+	}
+	options::OptionParser parser(default_value, false);
+	return parser.start_parsing<T>();
+}
+
 HierarchicalPseudoRedBlackSearchWrapper::HierarchicalPseudoRedBlackSearchWrapper(const options::Options &opts)
 	: SearchEngine<GlobalState, GlobalOperator>(opts),
+	  workers(),
 	  root_search_engine(),
+	  painting_registry(),
 	  rb_search_spaces(),
 	  num_black(get_num_black(opts, true)),
+	  time_applicable_ops(opts.get<bool>("time_applicable_ops")),
 	  never_black_variables(PaintingFactory::get_cg_leaves_painting()),
+	  plan_repair_heuristic(),
 	  hierarchical_red_black_search_statistics(),
 	  search_timer(),
 	  statistics_interval(opts.get<int>("statistics_interval")),
-	  next_print_time(0) {
+	  next_print_time(0),
+	  max_painting_memory(opts.get<int>("max_painting_memory")),
+	  steps_since_eviction_check(0) {
 	auto rb_search_options = get_rb_search_options(opts);
-	auto root_rb_data = std::make_shared<RBData>(*opts.get<std::shared_ptr<Painting>>("base_painting"));
-	auto root_state_registry = std::shared_ptr<RBStateRegistry>(root_rb_data->construct_state_registry(g_initial_state_data));
-	auto root_red_actions_manager = opts.get<bool>("repair_red_plans") ? std::make_shared<RedActionsManager>(root_state_registry->get_operators()) : nullptr;
-	auto root_search_space = std::make_shared<SearchSpace<RBState, RBOperator>>(*root_state_registry, static_cast<OperatorCost>(rb_search_options.get_enum("cost_type")));
-	rb_search_spaces.insert({root_rb_data->painting.get_painting(), {root_rb_data, root_state_registry, root_red_actions_manager, root_search_space}});
-	auto plan_repair_heuristic = get_rb_plan_repair_heuristic(opts);
+	const auto &root_painting = *opts.get<std::shared_ptr<Painting>>("base_painting");
+	auto [root_rb_data, root_state_registry, root_red_actions_manager, root_search_space, root_corresponding_global_state] =
+		create_painting_data(root_painting, g_initial_state_data, rb_search_options, opts.get<bool>("repair_red_plans"), hierarchical_red_black_search_statistics);
+	painting_registry.insert(root_rb_data->painting.get_painting());
+	rb_search_spaces.push_back({root_rb_data, root_state_registry, root_red_actions_manager, root_search_space, root_corresponding_global_state});
+	plan_repair_heuristic = get_rb_plan_repair_heuristic(opts);
 	if (plan_repair_heuristic)
 		for (auto black_index : plan_repair_heuristic->get_black_indices())
 			never_black_variables[black_index] = true;
+	auto rng = utils::parse_rng_from_options(opts);
+	const auto num_workers = opts.get<int>("num_workers");
+	if (num_workers > 1) {
+		// the workers share the axiom evaluator of the global state registries, which is not thread-safe
+		if (has_axioms()) {
+			std::cerr << "Error: the hierarchical red-black search does not support tasks with axioms when using several workers." << std::endl;
+			utils::exit_with(utils::ExitCode::UNSUPPORTED);
+		}
+		const auto &config = opts.get<options::ParseTree>("worker_config");
+		if (std::any_of(options::first_child_of_root(config), options::end_of_roots_children(config), [](const auto &argument) { return argument.key.empty(); })) {
+			std::cerr << "Error: the options of the hierarchical red-black search must be given with keywords when using several workers." << std::endl;
+			utils::exit_with(utils::ExitCode::INPUT_ERROR);
+		}
+		for (auto i = 0; i < num_workers; ++i) {
+			// only the heuristic and the painting strategy are parsed again, everything else is shared with the root search
+			auto worker_options = opts;
+			worker_options.set("heuristic", parse_argument<Heuristic<RBState, RBOperator> *>(config, "heuristic", DEFAULT_HEURISTIC));
+			worker_options.set("incremental_painting_strategy", parse_argument<std::shared_ptr<IncrementalPaintingStrategy>>(
+				config, "incremental_painting_strategy", DEFAULT_INCREMENTAL_PAINTING_STRATEGY));
+			if (worker_options.get<Heuristic<RBState, RBOperator> *>("heuristic") == opts.get<Heuristic<RBState, RBOperator> *>("heuristic")) {
+				std::cerr << "Error: the workers of the hierarchical red-black search must not share heuristics." << std::endl;
+				utils::exit_with(utils::ExitCode::INPUT_ERROR);
+			}
+			const auto seed = (*rng)(std::numeric_limits<int>::max());
+			worker_options.set("random_seed", seed);
+			workers.push_back(std::make_unique<HierarchicalPseudoRedBlackSearchWorker>(get_rb_search_options(worker_options), std::make_shared<utils::RandomNumberGenerator>(seed)));
+		}
+		// make sure the lazily computed task data is set up before the workers read it concurrently
+		has_conditional_effects();
+		causal_graph::get_causal_graph(g_root_task().get());
+		SharedTaskData::get();
+		// the output of the workers is written by the main thread after each batch of steps
+		static ThreadOutputBuffer output_buffer(std::cout);
+		std::cout << "Advancing the child searches of the root search with " << num_workers << " workers" << std::endl;
+	}
 	root_search_engine = std::make_unique<HierarchicalPseudoRedBlackSearch>(
-		rb_search_options, root_state_registry, root_search_space, state_registry->get_initial_state(),
-		*state_registry, *search_space, rb_search_spaces, plan_repair_heuristic, root_red_actions_manager,
-		never_black_variables, hierarchical_red_black_search_statistics, statistics, num_black);
+		rb_search_options, root_state_registry, root_search_space, root_corresponding_global_state, state_registry->get_initial_state(),
+		*state_registry, *search_space, painting_registry, rb_search_spaces, plan_repair_heuristic, root_red_actions_manager,
+		rng, never_black_variables, hierarchical_red_black_search_statistics, statistics, num_black);
+	if (!workers.empty())
+		root_search_engine->set_workers(workers);
 	++hierarchical_red_black_search_statistics.num_openend_searches;
 	++hierarchical_red_black_search_statistics.num_distinct_paintings;
 	auto initial_node = search_space->get_node(state_registry->get_initial_state());
@@ -521,6 +938,8 @@ auto HierarchicalPseudoRedBlackSearchWrapper::get_rb_plan_repair_heuristic(const
 	plan_repair_options.set<bool>("next_red_action_test", true);
 	plan_repair_options.set<bool>("use_connected", true);
 	plan_repair_options.set<bool>("extract_plan_no_blacks", false);
+	plan_repair_options.set<bool>("bitset_semi_relaxed_state", opts.get<bool>("bitset_semi_relaxed_state"));
+	plan_repair_options.set<int>("semi_relaxed_plan_cache_size", opts.get<int>("semi_relaxed_plan_cache_size"));
 	auto mercury_heuristic = std::make_shared<RedBlackDAGFactFollowingHeuristic>(plan_repair_options);
 	if (mercury_heuristic->get_num_black() == 0)
 		return nullptr;
@@ -543,12 +962,25 @@ auto HierarchicalPseudoRedBlackSearchWrapper::get_rb_search_options(const option
 
 void HierarchicalPseudoRedBlackSearchWrapper::add_options_to_parser(options::OptionParser &parser) {
 	parser.add_option<std::shared_ptr<Painting>>("base_painting", "painting to be used in the initial red-black search", "all_red()");
-	parser.add_option<Heuristic<RBState, RBOperator> *>("heuristic", "red-black heuristic that will be passed to the underlying red-black search engine", "ff_rb(transform=adapt_costs(cost_type=1))");
-	parser.add_option<std::shared_ptr<IncrementalPaintingStrategy>>("incremental_painting_strategy", "strategy for painting more variables black after finding a red-black solution with conflicts", "least_conflicts()");
+	parser.add_option<Heuristic<RBState, RBOperator> *>("heuristic", "red-black heuristic that will be passed to the underlying red-black search engine", DEFAULT_HEURISTIC);
+	parser.add_option<std::shared_ptr<IncrementalPaintingStrategy>>("incremental_painting_strategy", "strategy for painting more variables black after finding a red-black solution with conflicts", DEFAULT_INCREMENTAL_PAINTING_STRATEGY);
 	parser.add_option<bool>("repair_red_plans", "attempt to repair red plans using Mercury", "true");
-	parser.add_option<bool>("force_completeness", "force completeness by generating random paintings in incomplete unsolved subsearches", "false");
+	parser.add_option<bool>("bitset_semi_relaxed_state", "store the semi-relaxed states of the Mercury plan repair as bitsets instead of sorted value lists", "true");
+	parser.add_option<int>("semi_relaxed_plan_cache_size", "maximum number of cached results of the Mercury plan repair (0 disables the cache)", "10000", options::Bounds("0", "infinity"));
+	parser.add_option<bool>("force_completeness", "force completeness by generating random paintings in incomplete unsolved subsearches (using random_seed)", "false");
 	parser.add_option<int>("statistics_interval", "Print statistics every x seconds. If this is set to -1, statistics will not be printed during search.", "30");
+	parser.add_option<int>("max_painting_memory", "Memory budget in MB for the state registries, search spaces and operator data of all paintings. "
+		"When it is exceeded, the data of paintings that are not used by any unfinished search is released. If this is set to -1, there is no budget.", "-1", options::Bounds("-1", "infinity"));
+	parser.add_option<int>("num_workers", "Number of threads that advance the child searches of the root search. Each child search of the root search is assigned to a worker, "
+		"and the child searches of different workers do 100 steps at a time concurrently. Each worker parses its own heuristic and incremental_painting_strategy "
+		"and sets up its own global state registry and search space and the data of its paintings (also paintings that other workers use as well), the plan "
+		"repair heuristic and all other options are shared. Each additional worker therefore costs the memory of one red-black heuristic and of the states and "
+		"paintings of its searches, and the painting statistics count paintings once per worker; max_painting_memory applies to the paintings of all workers. "
+		"The output of the workers is written after each batch of steps. The results are reproducible for a fixed random_seed and number of workers. "
+		"An incremental painting strategy that uses randomization needs its own random_seed, since the default random number generator is shared and not thread-safe. "
+		"With several workers, the options have to be given with keywords. Tasks with axioms are only supported with one worker.", "1", options::Bounds("1", "infinity"));
 	add_num_black_options(parser);
+	add_state_saturation_options(parser);
 	add_succ_order_options(parser);
 }
 
@@ -559,6 +991,8 @@ static std::shared_ptr<SearchEngine<GlobalState, GlobalOperator>> _parse(options
 	auto opts = parser.parse();
 	if (parser.help_mode() || parser.dry_run())
 		return nullptr;
+	// the workers parse their heuristic and painting strategy again
+	opts.set("worker_config", *parser.get_parse_tree());
 	return std::make_shared<HierarchicalPseudoRedBlackSearchWrapper>(opts);
 }
 
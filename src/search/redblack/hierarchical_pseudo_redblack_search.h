@@ -8,6 +8,9 @@
 #include "rb_data.h"
 #include "red_actions_manager.h"
 #include "mercury/red_black_DAG_fact_following_heuristic.h"
+#include "../per_state_information.h"
+
+#include <optional>
 
 
 #ifdef _MSC_VER
@@ -19,6 +22,10 @@ namespace options {
 class Options;
 }
 
+namespace utils {
+class RandomNumberGenerator;
+}
+
 namespace redblack {
 
 struct HierarchicalPseudoRedBlackSearchStatistics {
@@ -27,29 +34,81 @@ struct HierarchicalPseudoRedBlackSearchStatistics {
 		num_distinct_paintings(0),
 		num_failed_incomplete_searches(0),
 		max_num_black(0),
-		total_num_evaluations(0) {}
+		total_num_evaluations(0),
+		painting_setup_time(0),
+		painting_setup_bytes(0),
+		num_evicted_paintings(0),
+		num_recreated_paintings(0),
+		evicted_bytes(0),
+		evicted_applicable_ops_time(0) {}
 
 	int num_openend_searches;
 	int num_distinct_paintings;
 	int num_failed_incomplete_searches;
 	int max_num_black;
 	int total_num_evaluations;
+	// time and (estimated) memory for setting up the painting-specific data of all distinct paintings
+	double painting_setup_time;
+	std::size_t painting_setup_bytes;
+	// paintings whose data was released to stay within max_painting_memory, and how often it had to be set up again
+	int num_evicted_paintings;
+	int num_recreated_paintings;
+	std::size_t evicted_bytes;
+	// time spent generating applicable operators in evicted paintings, the other paintings keep track of it in their state registry
+	double evicted_applicable_ops_time;
+
+	void add(const HierarchicalPseudoRedBlackSearchStatistics &other);
 };
 
 class IncrementalPaintingStrategy;
 
+// the global state from which each red-black state was evaluated, shared by all searches with the same painting
+using CorrespondingGlobalStates = PerStateInformation<StateID, RBState, RBOperator>;
+
+using PaintingData = std::tuple<std::shared_ptr<RBData>, std::shared_ptr<RBStateRegistry>, std::shared_ptr<RedActionsManager>, std::shared_ptr<SearchSpace<RBState, RBOperator>>, std::shared_ptr<CorrespondingGlobalStates>>;
+
+/*
+  Everything the searches below a child search of the root search write to (see num_workers). Each worker has
+  its own global state registry and search space, paintings, red-black heuristic, incremental painting strategy
+  and random number generator, so the child searches of different workers can be advanced concurrently. All
+  other options and the plan repair heuristic are shared with the root search. The statistics are collected by
+  the root search after each batch of steps.
+*/
+struct HierarchicalPseudoRedBlackSearchWorker {
+	HierarchicalPseudoRedBlackSearchWorker(const options::Options &search_options,
+	                                       std::shared_ptr<utils::RandomNumberGenerator> rng);
+
+	// registers a state of the root search's global state registry as the initial state of a child search
+	auto import_root_state(const GlobalState &root_state) -> GlobalState;
+	void collect_statistics(HierarchicalPseudoRedBlackSearchStatistics &hierarchical_statistics, SearchStatistics &search_statistics);
+
+	const options::Options search_options;
+	StateRegistryBase<GlobalState, GlobalOperator> global_state_registry;
+	SearchSpace<GlobalState, GlobalOperator> global_search_space;
+	// the state of the root search's global state registry for each imported state
+	std::unordered_map<StateID, StateID> root_states;
+	PaintingRegistry painting_registry;
+	std::vector<PaintingData> rb_search_spaces;
+	std::shared_ptr<utils::RandomNumberGenerator> rng;
+	HierarchicalPseudoRedBlackSearchStatistics statistics;
+	SearchStatistics search_statistics;
+};
+
 class HierarchicalPseudoRedBlackSearch : public lazy_search::LazySearch<RBState, RBOperator> {
 public:
 	//explicit HierarchicalPseudoRedBlackSearch(const options::Options &opts);
 	HierarchicalPseudoRedBlackSearch(const options::Options &opts,
 	                           std::shared_ptr<RBStateRegistry> state_registry,
 	                           std::shared_ptr<SearchSpace<RBState, RBOperator>> search_space,
+	                           std::shared_ptr<CorrespondingGlobalStates> corresponding_global_state,
 	                           GlobalState current_initial_state,
 	                           StateRegistryBase<GlobalState, GlobalOperator> &global_state_registry,
 	                           SearchSpace<GlobalState, GlobalOperator> &global_search_space,
-	                           std::map<InternalPaintingType, std::tuple<std::shared_ptr<RBData>, std::shared_ptr<RBStateRegistry>, std::shared_ptr<RedActionsManager>, std::shared_ptr<SearchSpace<RBState, RBOperator>>>> &rb_search_spaces,
+	                           PaintingRegistry &painting_registry,
+	                           std::vector<PaintingData> &rb_search_spaces,
 	                           std::shared_ptr<RedBlackDAGFactFollowingHeuristic> plan_repair_heuristic,
 	                           std::shared_ptr<RedActionsManager> red_actions_manager,
+	                           std::shared_ptr<utils::RandomNumberGenerator> rng,
 	                           const std::vector<bool> &never_black_variables,
 	                           HierarchicalPseudoRedBlackSearchStatistics &hierarchical_red_black_search_statistics,
 	                           SearchStatistics &global_search_statistics,
@@ -60,9 +119,19 @@ public:
 	SearchStatus step() override;
 
 	auto get_goal_state() const -> StateID;
+	// the worker in whose global state registry the goal state is, nullptr if it is in the root registry
+	auto get_goal_worker() const -> const HierarchicalPseudoRedBlackSearchWorker *;
+
+	// only for the root search, distributes its child searches among the workers
+	void set_workers(std::vector<std::unique_ptr<HierarchicalPseudoRedBlackSearchWorker>> &workers);
 
 protected:
+	// number of steps a child search does in each batch of concurrent child search steps
+	static constexpr int CHILD_SEARCH_STEPS_PER_BATCH = 100;
+
 	SearchStatus fetch_next_state() override;
+	auto handle_child_search_result(SearchStatus result) -> SearchStatus;
+	auto step_child_searches_concurrently() -> SearchStatus;
 
 	static auto check_plan(const GlobalState &state, const std::vector<OperatorID> &plan, const std::vector<FactPair> &goal_facts) -> bool;
 	auto get_repaired_plan(const GlobalState &state, const std::vector<OperatorID> &plan, const std::vector<FactPair> &goal_facts) const -> std::vector<OperatorID>;
@@ -75,6 +144,8 @@ protected:
 
 	std::shared_ptr<RedBlackDAGFactFollowingHeuristic> plan_repair_heuristic;
 	std::shared_ptr<RedActionsManager> red_actions_manager;
+	// shared by all searches of the hierarchy, used to generate random paintings (force_completeness)
+	std::shared_ptr<utils::RandomNumberGenerator> rng;
 
 	const std::vector<bool> &never_black_variables;
 
@@ -87,9 +158,19 @@ protected:
 	std::unique_ptr<HierarchicalPseudoRedBlackSearch> *current_child_search;
 	int current_child_search_index;
 
+	// set for the root search if there are several workers, and for its child searches to the worker they use
+	std::vector<std::unique_ptr<HierarchicalPseudoRedBlackSearchWorker>> *workers;
+	HierarchicalPseudoRedBlackSearchWorker *worker;
+	int num_worker_searches;
+	const HierarchicalPseudoRedBlackSearchWorker *goal_worker;
+	// open list entry (with its key and whether it is preferred) that was removed while collecting a batch of
+	// child searches but is not part of it, it is handled next by fetch_next_state
+	std::optional<std::tuple<EdgeOpenListEntry, int, bool>> pending_open_list_entry;
+
 	std::vector<std::vector<OperatorID>> current_best_supporters;
 
-	std::unordered_map<StateID, StateID> corresponding_global_state;
+	// Each state of a painting is evaluated by only one of its searches, since they share the search space.
+	std::shared_ptr<CorrespondingGlobalStates> corresponding_global_state;
 	GlobalState current_global_state;
 
 	StateID global_goal_state;
@@ -99,7 +180,9 @@ protected:
 	GlobalState current_initial_state;
 	StateRegistryBase<GlobalState, GlobalOperator> &global_state_registry;
 	SearchSpace<GlobalState, GlobalOperator> &global_search_space;
-	std::map<InternalPaintingType, std::tuple<std::shared_ptr<RBData>, std::shared_ptr<RBStateRegistry>, std::shared_ptr<RedActionsManager>, std::shared_ptr<SearchSpace<RBState, RBOperator>>>> &rb_search_spaces;
+	PaintingRegistry &painting_registry;
+	// indexed by the painting ids of painting_registry
+	std::vector<PaintingData> &rb_search_spaces;
 	const int num_black;
 
 	const bool force_completeness;
@@ -124,11 +207,20 @@ protected:
 	static auto get_rb_search_options(const options::Options &opts) -> options::Options;
 	void update_statistics();
 
+	auto estimate_painting_memory_usage() const -> std::size_t;
+	auto get_num_paintings() const -> std::size_t;
+	void evict_paintings();
+
+	// the searches reference the data of the workers, so they have to be destroyed first
+	std::vector<std::unique_ptr<HierarchicalPseudoRedBlackSearchWorker>> workers;
 	std::unique_ptr<HierarchicalPseudoRedBlackSearch> root_search_engine;
-	std::map<InternalPaintingType, std::tuple<std::shared_ptr<RBData>, std::shared_ptr<RBStateRegistry>, std::shared_ptr<RedActionsManager>, std::shared_ptr<SearchSpace<RBState, RBOperator>>>> rb_search_spaces;
+	PaintingRegistry painting_registry;
+	std::vector<PaintingData> rb_search_spaces;
 	const int num_black;
+	const bool time_applicable_ops;
 
 	std::vector<bool> never_black_variables;
+	std::shared_ptr<RedBlackDAGFactFollowingHeuristic> plan_repair_heuristic;
 
 	HierarchicalPseudoRedBlackSearchStatistics hierarchical_red_black_search_statistics;
 
@@ -136,6 +228,11 @@ protected:
 	utils::Timer search_timer;
 	const int statistics_interval;
 	double next_print_time;
+
+	// memory budget (in MB) for the data of all paintings, -1 for no budget
+	static constexpr int EVICTION_CHECK_INTERVAL = 1000;
+	const int max_painting_memory;
+	int steps_since_eviction_check;
 };
 }
 
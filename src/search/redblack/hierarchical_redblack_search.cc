@@ -812,6 +812,8 @@ auto HierarchicalRedBlackSearchWrapper::get_rb_plan_repair_heuristic(const optio
 	plan_repair_options.set<bool>("next_red_action_test", true);
 	plan_repair_options.set<bool>("use_connected", true);
 	plan_repair_options.set<bool>("extract_plan_no_blacks", false);
+	plan_repair_options.set<bool>("bitset_semi_relaxed_state", true);
+	plan_repair_options.set<int>("semi_relaxed_plan_cache_size", 10000);
 	auto mercury_heuristic = std::make_shared<RedBlackDAGFactFollowingHeuristic>(plan_repair_options);
 	if (mercury_heuristic->get_num_black() == 0)
 		return nullptr;
@@ -1,12 +1,13 @@
 #include "incremental_painting_strategy.h"
 
-#include "painting_utils.h"
+#include "shared_task_data.h"
 #include "util.h"
 #include "../global_operator.h"
 #include "../globals.h"
 #include "../options/options.h"
 #include "../options/option_parser.h"
 #include "../options/plugin.h"
+#include "../task_utils/causal_graph.h"
 #include "../utils/rng_options.h"
 
 #ifdef _MSC_VER
@@ -40,23 +41,14 @@ void IncrementalPaintingStrategy::add_options_to_parser(options::OptionParser &p
 	add_num_black_options(parser);
 }
 
-auto LeastConflictsPaintingStrategy::get_variable_levels() -> std::vector<int> {
-	auto scc_levels = rbutils::get_scc_levels(rbutils::get_sccs({}));
-	auto variable_levels = std::vector<int>(g_root_task()->get_num_variables(), -1);
-	for (auto lvl = static_cast<std::size_t>(0); lvl < scc_levels.size(); ++lvl) {
-		for (const auto &scc : scc_levels[lvl]) {
-			for (auto var : scc) {
-				assert(variable_levels[var] == -1);
-				variable_levels[var] = lvl;
-			}
-		}
-	}
-	return variable_levels;
+auto LeastConflictsPaintingStrategy::get_variable_levels() -> const std::vector<int> & {
+	return CausalGraphSCCs::get().get_variable_levels();
 }
 
 LeastConflictsPaintingStrategy::LeastConflictsPaintingStrategy(const options::Options &opts)
 	: IncrementalPaintingStrategy(opts),
-	  prefer_lvl(opts.get<bool>("prefer_lvl")) {}
+	  prefer_lvl(opts.get<bool>("prefer_lvl")),
+	  num_candidates(opts.get<int>("num_candidates")) {}
 
 auto LeastConflictsPaintingStrategy::generate_next_painting(const Painting &last_painting, const std::vector<OperatorID> &last_plan, const GlobalState &initial_state, const std::vector<FactPair> &goal_facts, const std::vector<bool> *never_black_variables) -> Painting {
 	assert(!std::all_of(std::begin(last_painting.get_painting()), std::end(last_painting.get_painting()), [](const auto is_red) { return !is_red; }));
@@ -99,7 +91,9 @@ auto LeastConflictsPaintingStrategy::generate_next_painting(const Painting &last
 	int curr_lvl = 0;
 	auto do_prefer_lvl = prefer_lvl;
 	const auto target_num_black = std::min<std::size_t>(current_num_black + num_black, g_root_task()->get_num_variables());
-	while (current_num_black < target_num_black) {
+	// the variables that are painted black in the order in which they are chosen, the candidates use alternatives for the last one
+	auto chosen_variables = std::vector<int>();
+	while (current_num_black < target_num_black + num_candidates - 1) {
 		// ignoring the force_cg_leaves_red flag here, since CG leaves should
 		// never have a conflict.
 		int max = -1;
@@ -117,20 +111,38 @@ auto LeastConflictsPaintingStrategy::generate_next_painting(const Painting &last
 			}
 			continue;
 		}
+		if (i == -1 && current_num_black >= target_num_black)
+			// no alternatives left for the candidates
+			break;
 		assert(i != -1);
 		assert(painting[i]);
 		painting[i] = false;
 		assert(!(never_black_variables && never_black_variables->at(i)));
 		++current_num_black;
+		chosen_variables.push_back(i);
 	}
-
-	return painting;
+	if (num_candidates == 1 || chosen_variables.empty())
+		return painting;
+
+	const auto num_fixed_variables = chosen_variables.size() - (current_num_black - target_num_black) - 1;
+	for (auto i = num_fixed_variables; i < chosen_variables.size(); ++i)
+		painting[chosen_variables[i]] = true;
+	auto candidates = std::vector<InternalPaintingType>();
+	for (auto i = num_fixed_variables; i < chosen_variables.size(); ++i) {
+		candidates.push_back(painting);
+		candidates.back()[chosen_variables[i]] = false;
+	}
+	return candidates[get_least_conflicts_candidate(candidates, initial_state.get_values(), goal_facts)];
 }
 
 static auto _parse_least_conflicts(options::OptionParser &parser) -> std::shared_ptr<IncrementalPaintingStrategy> {
 	IncrementalPaintingStrategy::add_options_to_parser(parser);
 
 	parser.add_option<bool>("prefer_lvl", "TODO", "false");
+	parser.add_option<int>("num_candidates", "number of candidate paintings, the candidates differ in the last variable that is painted black (the one with the most "
+		"conflicts, the one with the second most conflicts and so on). If there is more than one candidate, the one whose red variables have the fewest conflicts "
+		"in the relaxed plan from the initial state of the next search is used. The candidates are evaluated one after another.",
+		"1", options::Bounds("1", "infinity"));
 
 	if (parser.help_mode() || parser.dry_run())
 		return nullptr;
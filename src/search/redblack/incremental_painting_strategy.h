@@ -31,8 +31,10 @@ public:
 
 class LeastConflictsPaintingStrategy : public IncrementalPaintingStrategy {
 	const bool prefer_lvl;
+	// number of candidate paintings that are compared by the conflicts of their red plan
+	const int num_candidates;
 
-	static auto get_variable_levels() -> std::vector<int>;
+	static auto get_variable_levels() -> const std::vector<int> &;
 
 public:
 	LeastConflictsPaintingStrategy(const options::Options &opts);
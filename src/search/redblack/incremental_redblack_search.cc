@@ -6,6 +6,7 @@
 #include "../search_engines/lazy_search.h"
 #include "../search_engines/search_common.h"
 #include "incremental_painting_strategy.h"
+#include "rb_ff_heuristic.h"
 
 
 namespace redblack {
@@ -32,8 +33,17 @@ IncrementalRedBlackSearch::IncrementalRedBlackSearch(const options::Options &opt
 	  plan_repair_heuristic(get_rb_plan_repair_heuristic(opts)),
 	  red_actions_manager(),
 	  always_recompute_red_plans(opts.get<bool>("always_recompute_red_plans")),
-	  never_black_variables(PaintingFactory::get_cg_leaves_painting()) {
-	auto rb_state_registry = rb_data->construct_state_registry(g_initial_state_data);
+	  state_saturation_type(get_state_saturation_type(opts)),
+	  incremental_saturation(opts.get<bool>("incremental_saturation")),
+	  compress_states(opts.get<bool>("compress_states")),
+	  time_applicable_ops(opts.get<bool>("time_applicable_ops")),
+	  episode_max_expansions(opts.get<int>("episode_max_expansions")),
+	  episode_max_time(opts.get<double>("episode_max_time")),
+	  episode_max_registry_memory(opts.get<int>("episode_max_registry_memory")),
+	  never_black_variables(PaintingFactory::get_cg_leaves_painting()),
+	  episode_timer(),
+	  ignore_episode_budgets(false) {
+	auto rb_state_registry = rb_data->construct_state_registry(g_initial_state_data, state_saturation_type, incremental_saturation, compress_states, time_applicable_ops);
 	if (plan_repair_heuristic) {
 		red_actions_manager = std::make_unique<RedActionsManager>(rb_state_registry->get_operators());
 		for (auto black_index : plan_repair_heuristic->get_black_indices())
@@ -58,6 +68,69 @@ void IncrementalRedBlackSearch::initialize_rb_search_engine() {
 	auto pref_operator_heuristics = rb_search_engine_options.get_list<Heuristic<RBState, RBOperator> *>("preferred");
 	rb_search_engine->set_pref_operator_heuristics(pref_operator_heuristics);
 	rb_search_engine->initialize();
+	episode_timer.reset();
+	ignore_episode_budgets = false;
+}
+
+void IncrementalRedBlackSearch::start_episode(const Painting &painting) {
+	rb_data = std::make_unique<RBData>(painting);
+	auto rb_state_registry = rb_data->construct_state_registry(current_initial_state.get_values(), state_saturation_type, incremental_saturation, compress_states, time_applicable_ops);
+	if (plan_repair_heuristic)
+		red_actions_manager = std::make_unique<RedActionsManager>(rb_state_registry->get_operators());
+	rb_search_engine = std::make_unique<InternalRBSearchEngine>(rb_search_engine_options, std::move(rb_state_registry));
+	initialize_rb_search_engine();
+	assert(rb_search_engine->get_status() == IN_PROGRESS);
+	++incremental_redblack_search_statistics.num_episodes;
+}
+
+auto IncrementalRedBlackSearch::get_exceeded_episode_budget() const -> EpisodeBudget {
+	if (episode_max_expansions != -1 && rb_search_engine->statistics.get_expanded() >= episode_max_expansions)
+		return EpisodeBudget::EXPANSIONS;
+	if (episode_max_registry_memory != -1) {
+		const auto &rb_state_registry = rb_search_engine->get_state_registry();
+		if (rb_state_registry.get_state_data_memory_usage() >= static_cast<std::size_t>(episode_max_registry_memory) * 1024 * 1024)
+			return EpisodeBudget::REGISTRY_MEMORY;
+	}
+	if (episode_max_time != std::numeric_limits<double>::infinity() && episode_timer() >= episode_max_time)
+		return EpisodeBudget::TIME;
+	return EpisodeBudget::NONE;
+}
+
+auto IncrementalRedBlackSearch::can_paint_more_variables_black() const -> bool {
+	for (auto var = 0; var < g_root_task()->get_num_variables(); ++var)
+		if (rb_data->painting.is_red_var(var) && !never_black_variables[var])
+			return true;
+	return false;
+}
+
+void IncrementalRedBlackSearch::abort_episode(EpisodeBudget exceeded_budget) {
+	switch (exceeded_budget) {
+	case EpisodeBudget::EXPANSIONS:
+		++incremental_redblack_search_statistics.num_aborted_episodes_expansions;
+		break;
+	case EpisodeBudget::TIME:
+		++incremental_redblack_search_statistics.num_aborted_episodes_time;
+		break;
+	case EpisodeBudget::REGISTRY_MEMORY:
+		++incremental_redblack_search_statistics.num_aborted_episodes_registry_memory;
+		break;
+	case EpisodeBudget::NONE:
+		assert(false);
+	}
+	update_statistics();
+	// without a red-black plan, the only known conflicts are the goals on red variables that do not hold in the initial state
+	// (causal graph leaves are excluded, the painting strategies never paint them black)
+	const auto &causal_graph = causal_graph::get_causal_graph(g_root_task().get());
+	auto goal_facts = std::vector<FactPair>();
+	for (const auto &goal : g_goal)
+		if (rb_data->painting.is_red_var(goal.first) && !never_black_variables[goal.first] && !causal_graph.get_successors(goal.first).empty()
+			&& current_initial_state[goal.first] != goal.second)
+			goal_facts.emplace_back(goal.first, goal.second);
+	start_episode(incremental_painting_strategy->generate_next_painting(rb_data->painting, {}, current_initial_state, goal_facts, &never_black_variables));
+	const auto num_black = rb_data->painting.count_num_black();
+	std::cout << "Red-black search exceeded its budget. Search continues with a new painting, "
+		<< num_black << " black variables ("
+		<< (num_black / static_cast<double>(g_root_task()->get_num_variables())) * 100 << "%)..." << std::endl;
 }
 
 void IncrementalRedBlackSearch::update_statistics() {
@@ -68,6 +141,9 @@ void IncrementalRedBlackSearch::update_statistics() {
 	statistics.inc_generated(rb_search_engine->statistics.get_generated());
 	statistics.inc_generated_ops(rb_search_engine->statistics.get_generated_ops());
 	statistics.inc_reopened(rb_search_engine->statistics.get_reopened());
+	const auto applicable_ops_time = static_cast<RBStateRegistry *>(&rb_search_engine->get_state_registry())->get_applicable_ops_time();
+	incremental_redblack_search_statistics.applicable_ops_time += applicable_ops_time;
+	incremental_redblack_search_statistics.max_applicable_ops_time = std::max(applicable_ops_time, incremental_redblack_search_statistics.max_applicable_ops_time);
 }
 
 auto IncrementalRedBlackSearch::get_successor_and_update_search_space(const GlobalState &state, const GlobalOperator& op) -> GlobalState {
@@ -431,6 +507,8 @@ auto IncrementalRedBlackSearch::get_rb_plan_repair_heuristic(const options::Opti
 	plan_repair_options.set<bool>("next_red_action_test", true);
 	plan_repair_options.set<bool>("use_connected", true);
 	plan_repair_options.set<bool>("extract_plan_no_blacks", false);
+	plan_repair_options.set<bool>("bitset_semi_relaxed_state", opts.get<bool>("bitset_semi_relaxed_state"));
+	plan_repair_options.set<int>("semi_relaxed_plan_cache_size", opts.get<int>("semi_relaxed_plan_cache_size"));
 	auto mercury_heuristic = std::make_shared<RedBlackDAGFactFollowingHeuristic>(plan_repair_options);
 	if (mercury_heuristic->get_num_black() == 0)
 		return nullptr;
@@ -443,16 +521,33 @@ void IncrementalRedBlackSearch::add_options_to_parser(options::OptionParser &par
 	parser.add_option<std::shared_ptr<IncrementalPaintingStrategy>>("incremental_painting_strategy", "strategy for painting more variables black after finding a red-black solution with conflicts", "least_conflicts()");
 	parser.add_option<bool>("continue_from_first_conflict", "Continue next iteration of red-black search from the first conflicting state in the previous red-black plan.", "true");
 	parser.add_option<bool>("repair_red_plans", "attempt to repair red plans using Mercury", "true");
+	parser.add_option<bool>("bitset_semi_relaxed_state", "store the semi-relaxed states of the Mercury plan repair as bitsets instead of sorted value lists", "true");
+	parser.add_option<int>("semi_relaxed_plan_cache_size", "maximum number of cached results of the Mercury plan repair (0 disables the cache)", "10000", options::Bounds("0", "infinity"));
 	parser.add_option<bool>("always_recompute_red_plans", "when trying to repair red partial plans, always replace the old red plan by a new one based on the real state", "true");
+	parser.add_option<int>("episode_max_expansions", "maximum number of expansions of a single red-black search before it is aborted and the painting is updated (-1 for no limit)", "-1", options::Bounds("-1", "infinity"));
+	parser.add_option<double>("episode_max_time", "maximum wall-clock time in seconds of a single red-black search before it is aborted and the painting is updated", "infinity", options::Bounds("0", "infinity"));
+	parser.add_option<int>("episode_max_registry_memory", "maximum size in MB of the states registered by a single red-black search before it is aborted and the painting is updated (-1 for no limit)", "-1", options::Bounds("-1", "infinity"));
+	add_state_saturation_options(parser);
 	add_succ_order_options(parser);
 }
 
 SearchStatus IncrementalRedBlackSearch::step() {
 	assert(rb_search_engine->get_status() == IN_PROGRESS);
 	auto status = rb_search_engine->step();
-	if (status != IN_PROGRESS)
-		update_statistics();
-	if (status == IN_PROGRESS || status == TIMEOUT)
+	if (status == IN_PROGRESS) {
+		const auto exceeded_budget = ignore_episode_budgets ? EpisodeBudget::NONE : get_exceeded_episode_budget();
+		if (exceeded_budget != EpisodeBudget::NONE) {
+			if (can_paint_more_variables_black()) {
+				abort_episode(exceeded_budget);
+			} else {
+				std::cout << "Red-black search exceeded its budget, but no more variables can be painted black. Continuing..." << std::endl;
+				ignore_episode_budgets = true;
+			}
+		}
+		return IN_PROGRESS;
+	}
+	update_statistics();
+	if (status == TIMEOUT)
 		return status;
 	if (status == FAILED) {
 		if (current_initial_state.get_id() == state_registry->get_initial_state().get_id()) {
@@ -468,7 +563,7 @@ SearchStatus IncrementalRedBlackSearch::step() {
 			  search (from a different initial state), but this is VERY
 			  difficult to do with FD's data structures.
 			*/
-			rb_search_engine = std::make_unique<InternalRBSearchEngine>(rb_search_engine_options, rb_data->construct_state_registry(current_initial_state.get_values()));
+			rb_search_engine = std::make_unique<InternalRBSearchEngine>(rb_search_engine_options, rb_data->construct_state_registry(current_initial_state.get_values(), state_saturation_type, incremental_saturation, compress_states, time_applicable_ops));
 			initialize_rb_search_engine();
 			assert(rb_search_engine->get_status() == IN_PROGRESS);
 			++incremental_redblack_search_statistics.num_restarts;
@@ -513,24 +608,26 @@ SearchStatus IncrementalRedBlackSearch::step() {
 		std::transform(std::begin(rb_plan), std::end(rb_plan), std::back_inserter(plan),
 			[](const auto rb_operator) { return OperatorID(get_op_index_hacked(rb_operator)); });
 	}
-	rb_data = std::make_unique<RBData>(incremental_painting_strategy->generate_next_painting(rb_data->painting, plan, current_initial_state, &never_black_variables));
-	const auto num_black = std::count_if(std::begin(rb_data->painting.get_painting()), std::end(rb_data->painting.get_painting()),
-		[](auto b) { return !b; });
+	auto next_painting = incremental_painting_strategy->generate_next_painting(rb_data->painting, plan, current_initial_state, &never_black_variables);
+	const auto num_black = next_painting.count_num_black();
 	std::cout << "Red-black plan is not a real plan. Search continues with a new painting, "
 		<< num_black << " black variables ("
 		<< (num_black / static_cast<double>(g_root_task()->get_num_variables())) * 100 << "%)..." << std::endl;
 	if (continue_from_first_conflict)
 		current_initial_state = resulting_state;
-	auto rb_state_registry = rb_data->construct_state_registry(current_initial_state.get_values());
-	if (plan_repair_heuristic)
-		red_actions_manager = std::make_unique<RedActionsManager>(rb_state_registry->get_operators());
-	rb_search_engine = std::make_unique<InternalRBSearchEngine>(rb_search_engine_options, std::move(rb_state_registry));
-	initialize_rb_search_engine();
-	assert(rb_search_engine->get_status() == IN_PROGRESS);
-	++incremental_redblack_search_statistics.num_episodes;
+	start_episode(next_painting);
 	return IN_PROGRESS;
 }
 
+auto IncrementalRedBlackSearch::get_rb_heuristics() const -> std::set<Heuristic<RBState, RBOperator> *> {
+	auto heuristics = std::set<Heuristic<RBState, RBOperator> *>();
+	for (auto evaluator : rb_search_engine_options.get_list<Evaluator<RBState, RBOperator> *>("evals"))
+		evaluator->get_involved_heuristics(heuristics);
+	for (auto heuristic : rb_search_engine_options.get_list<Heuristic<RBState, RBOperator> *>("preferred"))
+		heuristics.insert(heuristic);
+	return heuristics;
+}
+
 void IncrementalRedBlackSearch::print_statistics() const {
 	auto num_black = std::count_if(std::begin(rb_data->painting.get_painting()), std::end(rb_data->painting.get_painting()),
 		[](auto b) { return !b; });
@@ -542,6 +639,17 @@ void IncrementalRedBlackSearch::print_statistics() const {
 	std::cout << "Performed " << incremental_redblack_search_statistics.num_episodes << " episodes of red-black search." << std::endl;
 	std::cout << "Search was restarted " << incremental_redblack_search_statistics.num_restarts << " times after red-black search failed to find a solution." << std::endl;
 	std::cout << "Number of broken red plans: " << incremental_redblack_search_statistics.num_broken_red_plans << std::endl;
+	if (time_applicable_ops)
+		std::cout << "Applicable operator generation time: " << incremental_redblack_search_statistics.applicable_ops_time << "s"
+			<< " (at most " << incremental_redblack_search_statistics.max_applicable_ops_time << "s per red-black search)" << std::endl;
+	std::cout << "Aborted red-black searches: " << incremental_redblack_search_statistics.num_aborted_episodes_expansions << " (expansions), "
+		<< incremental_redblack_search_statistics.num_aborted_episodes_time << " (time), "
+		<< incremental_redblack_search_statistics.num_aborted_episodes_registry_memory << " (registry memory)" << std::endl;
+	if (plan_repair_heuristic)
+		print_semi_relaxed_plan_statistics(*plan_repair_heuristic);
+	for (auto heuristic : get_rb_heuristics())
+		if (auto rb_ff_heuristic = dynamic_cast<const RBFFHeuristic *>(heuristic))
+			rb_ff_heuristic->print_statistics();
 	statistics.print_detailed_statistics();
 	search_space->print_statistics();
 }
@@ -29,6 +29,10 @@ public:
 	static void add_options_to_parser(options::OptionParser &);
 
 	SearchStatus step() override;
+	void print_statistics() const override;
+
+	// heuristics used by the internal red-black searches
+	auto get_rb_heuristics() const -> std::set<Heuristic<RBState, RBOperator> *>;
 
 protected:
 	using RBPlan = std::vector<const RBOperator *>;
@@ -36,6 +40,7 @@ protected:
 	const options::Options rb_search_engine_options;
 
 	void initialize_rb_search_engine();
+	void start_episode(const Painting &painting);
 	void update_statistics();
 	auto get_successor_and_update_search_space(const GlobalState &current_state, const GlobalOperator &op) -> GlobalState;
 	auto check_plan_and_update_search_space(const GlobalState &state, const std::vector<OperatorID> &plan, const std::vector<FactPair> &goal_facts) -> std::pair<bool, GlobalState>;
@@ -54,19 +59,40 @@ protected:
 
 	void set_solution(const Plan &partial_plan, const GlobalState &state);
 
-	void print_statistics() const override;
-
 	struct IncrementalRedBlackSearchStatistics {
 		IncrementalRedBlackSearchStatistics()
 			: num_episodes(0),
 			  num_restarts(0),
-			  num_broken_red_plans(0) {}
+			  num_broken_red_plans(0),
+			  applicable_ops_time(0),
+			  max_applicable_ops_time(0),
+			  num_aborted_episodes_expansions(0),
+			  num_aborted_episodes_time(0),
+			  num_aborted_episodes_registry_memory(0) {}
 
 		int num_episodes;
 		int num_restarts;
 		int num_broken_red_plans;
+		// time for generating applicable operators in the red-black searches, in total and the maximum of a single search
+		double applicable_ops_time;
+		double max_applicable_ops_time;
+		// number of red-black searches that were aborted because they exceeded the respective episode budget
+		int num_aborted_episodes_expansions;
+		int num_aborted_episodes_time;
+		int num_aborted_episodes_registry_memory;
 	} incremental_redblack_search_statistics;
 
+	enum class EpisodeBudget {
+		NONE,
+		EXPANSIONS,
+		TIME,
+		REGISTRY_MEMORY
+	};
+
+	auto get_exceeded_episode_budget() const -> EpisodeBudget;
+	auto can_paint_more_variables_black() const -> bool;
+	void abort_episode(EpisodeBudget exceeded_budget);
+
 	std::unique_ptr<RBData> rb_data;
 	std::unique_ptr<InternalRBSearchEngine> rb_search_engine;
 	std::shared_ptr<IncrementalPaintingStrategy> incremental_painting_strategy;
@@ -76,9 +102,22 @@ protected:
 	std::shared_ptr<RedBlackDAGFactFollowingHeuristic> plan_repair_heuristic;
 	std::unique_ptr<RedActionsManager> red_actions_manager;
 	const bool always_recompute_red_plans;
+	const StateSaturationType state_saturation_type;
+	const bool incremental_saturation;
+	const bool compress_states;
+	const bool time_applicable_ops;
+	// budgets of a single red-black search, -1 (infinity for the time) means no limit
+	const int episode_max_expansions;
+	const double episode_max_time;
+	const int episode_max_registry_memory;
 
 	std::vector<bool> never_black_variables;
 
+	// wall-clock time, the process CPU time also includes other threads such as the workers of the hierarchical search
+	WallClockTimer episode_timer;
+	// set if the budgets were exceeded but there is no variable left that could be painted black
+	bool ignore_episode_budgets;
+
 	static auto get_rb_search_options(const options::Options &options) -> options::Options;
 	static auto get_rb_plan_repair_heuristic(const options::Options &options) -> std::shared_ptr<RedBlackDAGFactFollowingHeuristic>;
 };
@@ -3,6 +3,8 @@
 #include "../globals.h"
 #include "../abstract_task.h"
 
+#include <bitset>
+
 namespace redblack {
 
 RBIntPacker::RBIntPacker(const Painting &painting)
@@ -48,6 +50,73 @@ void RBIntPacker::init_zero(Bin *buffer, int var) const {
 	}
 }
 
+auto RBIntPacker::get_num_red_words(int var) const -> int {
+	assert(painting.is_red_var(var));
+	return (g_variable_domain[var] + BITS_PER_BIN - 1) / BITS_PER_BIN;
+}
+
+auto RBIntPacker::get_red_values(const Bin *buffer, int var) const -> boost::dynamic_bitset<> {
+	using Block = boost::dynamic_bitset<>::block_type;
+	constexpr auto bits_per_block = boost::dynamic_bitset<>::bits_per_block;
+	static_assert(bits_per_block % BITS_PER_BIN == 0);
+	const auto num_words = get_num_red_words(var);
+	auto blocks = std::vector<Block>((num_words * BITS_PER_BIN + bits_per_block - 1) / bits_per_block, 0);
+	for (auto word = 0; word < num_words; ++word)
+		blocks[word * BITS_PER_BIN / bits_per_block] |= static_cast<Block>(get_red_word_info(var, word).get_bits(buffer)) << (word * BITS_PER_BIN % bits_per_block);
+	auto values = boost::dynamic_bitset<>(std::begin(blocks), std::end(blocks));
+	values.resize(g_variable_domain[var]);
+#ifndef NDEBUG
+	for (auto value = 0; value < g_variable_domain[var]; ++value)
+		assert(values[value] == get_bit(buffer, var, value));
+#endif
+	return values;
+}
+
+void RBIntPacker::set_red_values(Bin *buffer, int var, const boost::dynamic_bitset<> &values) const {
+	using Block = boost::dynamic_bitset<>::block_type;
+	constexpr auto bits_per_block = boost::dynamic_bitset<>::bits_per_block;
+	assert(static_cast<int>(values.size()) == g_variable_domain[var]);
+	auto blocks = std::vector<Block>();
+	blocks.reserve(values.num_blocks());
+	boost::to_block_range(values, std::back_inserter(blocks));
+	for (auto word = 0; word < get_num_red_words(var); ++word)
+		get_red_word_info(var, word).set_bits(buffer, static_cast<Bin>(blocks[word * BITS_PER_BIN / bits_per_block] >> (word * BITS_PER_BIN % bits_per_block)));
+#ifndef NDEBUG
+	for (auto value = 0; value < g_variable_domain[var]; ++value)
+		assert(values[value] == get_bit(buffer, var, value));
+#endif
+}
+
+void RBIntPacker::copy_red_values(const Bin *from, Bin *to, int var) const {
+	for (auto word = 0; word < get_num_red_words(var); ++word) {
+		const auto &info = get_red_word_info(var, word);
+		info.set_bits(to, info.get_bits(from));
+	}
+}
+
+void RBIntPacker::or_red_values(const Bin *from, Bin *to, int var) const {
+	for (auto word = 0; word < get_num_red_words(var); ++word) {
+		const auto &info = get_red_word_info(var, word);
+		info.set_bits(to, info.get_bits(to) | info.get_bits(from));
+	}
+}
+
+auto RBIntPacker::is_red_subset(const Bin *buffer, const Bin *other_buffer, int var) const -> bool {
+	for (auto word = 0; word < get_num_red_words(var); ++word) {
+		const auto &info = get_red_word_info(var, word);
+		if (info.get_bits(buffer) & ~info.get_bits(other_buffer))
+			return false;
+	}
+	return true;
+}
+
+auto RBIntPacker::count_red_values(const Bin *buffer, int var) const -> int {
+	auto count = 0;
+	for (auto word = 0; word < get_num_red_words(var); ++word)
+		count += std::bitset<BITS_PER_BIN>(get_red_word_info(var, word).get_bits(buffer)).count();
+	return count;
+}
+
 auto RBIntPacker::get_available_bits(int used_bits, std::vector<std::vector<int>> &bits_to_vars) -> int {
 	return used_bits == 0 ? bits_to_vars.size() - 1 : std::max(BITS_PER_BIN - used_bits, 0);
 }
@@ -2,6 +2,7 @@
 #define REDBLACK_INT_PACKER_H
 
 #include <vector>
+#include <boost/dynamic_bitset/dynamic_bitset.hpp>
 
 #include "painting.h"
 #include "../algorithms/int_packer.h"
@@ -26,14 +27,34 @@ class RBIntPacker : public int_packer::IntPacker {
 
 	int num_additional_bins;
 	std::vector<int> var_to_bin;
+
+	auto get_red_word_info(int var, int word) const -> const VariableInfo & {
+		return word == 0 ? var_infos[var] : var_infos[var_to_bin[var] + word - 1];
+	}
 public:
 	explicit RBIntPacker(const Painting &painting);
 	~RBIntPacker();
 
+	static constexpr auto BITS_PER_RED_WORD = BITS_PER_BIN;
+
+	// the i-th word of a red variable holds the values [i * BITS_PER_RED_WORD, (i + 1) * BITS_PER_RED_WORD)
+	auto get_num_red_words(int var) const -> int;
+	auto get_red_word(const Bin *buffer, int var, int word) const -> Bin {
+		return get_red_word_info(var, word).get_bits(buffer);
+	}
+
 	bool get_bit(const Bin *buffer, int var, int value) const;
 	void set_bit(Bin *buffer, int var, int value) const;
 	void init_zero(Bin *buffer, int var) const;
 
+	// word-level operations on the set of values of a red variable
+	auto get_red_values(const Bin *buffer, int var) const -> boost::dynamic_bitset<>;
+	void set_red_values(Bin *buffer, int var, const boost::dynamic_bitset<> &values) const;
+	void copy_red_values(const Bin *from, Bin *to, int var) const;
+	void or_red_values(const Bin *from, Bin *to, int var) const;
+	auto is_red_subset(const Bin *buffer, const Bin *other_buffer, int var) const -> bool;
+	auto count_red_values(const Bin *buffer, int var) const -> int;
+
 	auto get_available_bits(int used_bits, std::vector<std::vector<int>> &bits_to_vars) -> int override;
 	auto get_bits_for_var(const std::vector<int> &ranges, int var, std::vector<std::vector<int>> &bits_to_vars) -> int override;
 	void update_var_info(int var, const std::vector<int> &ranges, int bin_index, int used_bits, int bits) override;
@@ -39,8 +39,8 @@ DtgOperators::DtgOperators(int v) : var(v), is_root(false),
 	dijkstra_ops = 0;
 	dijkstra_prev = 0;
 
-	solution = 0;
-	sol_edges = 0;
+	path_cache_next_victim = 0;
+	max_cached_targets = 0;
 
 	number_reachable_black_vals = -1;
 	number_sufficient_unachieved_vals = -1;
@@ -65,6 +65,7 @@ void DtgOperators::initialize_black(RedBlackDAGFactFollowingHeuristic* base) {
 	std::fill_n(dijkstra_prev, range, -1);
 
 	complete_forward_graph.assign(range, vector<GraphEdge>());
+	complete_backward_graph.assign(range, vector<GraphEdge>());
 	base_pointer = base;
 
 }
@@ -268,9 +269,9 @@ void DtgOperators::clear_black_data_for_red_var() {
 		complete_forward_graph[i].clear();
 
 	complete_forward_graph.clear();
+	complete_backward_graph.clear();
 
-	free_solution();
-	free_solution_edges_for_root();
+	clear_path_cache();
 }
 
 
@@ -512,164 +513,124 @@ ConnectivityStatus DtgOperators::check_connectivity() {
 	return ALL_CONNECTED_TO_GOAL;
 }
 
-void DtgOperators::calculate_shortest_paths_for_root() {
+void DtgOperators::prepare_shortest_paths_for_root() {
 	if (shortest_paths_calculated)
 		return;
-	shortest_paths_calculated = true;
 #ifdef DEBUG_RED_BLACK
-	cout << "=================> Variable " << var << " (" << g_variable_name[var] << ") with domain size " << range << " is root, calculating shortest paths in advance" << endl;
+	cout << "=================> Variable " << var << " (" << g_variable_name[var] << ") with domain size " << range << " is root, shortest paths are followed without search" << endl;
 #endif
 	set_root();
-	// All pairs shortest path
-	solution = new int*[range];
-	sol_edges = new vector<int>*[range];
-
-	for (int val0=0;val0<range;val0++) {  // Initialize
-		solution[val0] = new int[range];
-		sol_edges[val0] = new vector<int>[range];
-		for (int val1=0;val1<range;val1++) {
-			if (val0 == val1) {
-				solution[val0][val1] = 0;
-			} else {
-				solution[val0][val1] = numeric_limits<int>::max();
-			}
-		}
-		// Now going over the forward graph, setting the initial values
-		for (int e = 0; e < complete_forward_graph[val0].size(); e++) {
-			// Going over the edges
-			const GraphEdge& edge = complete_forward_graph[val0][e];
-
 #ifdef CRITICAL_RED_BLACK
+	// Root paths are followed without checking the prevail conditions of their edges.
+	for (const auto &edges : complete_backward_graph) {
+		for (const auto &edge : edges) {
 			if (!edge.initially_enabled) {
 				cout << "Edge is not initially enabled for the root variable!! Bug!" << endl;
-				exit_with(EXIT_CRITICAL_ERROR);
+				utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
 			}
-#endif
-			int to_val = edge.to;
-			assert(to_val >= 0 && to_val < range);
-			solution[val0][to_val] = edge.cost;
-			sol_edges[val0][to_val].push_back(edge.op_no);
 		}
 	}
-
-	for (int k=0;k<range;k++) {
-		for (int i=0;i<range;i++) {
-			if (solution[i][k] == numeric_limits<int>::max())  // In this case, no update is possible
-				continue;
-			for (int j=0;j<range;j++) {
-				if (solution[k][j] == numeric_limits<int>::max())  // In this case, no update is possible
-					continue;
-
-				int new_dist = solution[i][k] + solution[k][j];
-				if (new_dist < solution[i][j]) {
-					// Update
-					solution[i][j] = new_dist;
-					sol_edges[i][j].clear();
-					sol_edges[i][j].reserve(sol_edges[i][k].size() + sol_edges[k][j].size());
-					sol_edges[i][j].insert(sol_edges[i][j].end(), sol_edges[i][k].begin(), sol_edges[i][k].end());
-					sol_edges[i][j].insert(sol_edges[i][j].end(), sol_edges[k][j].begin(), sol_edges[k][j].end());
-				}
-			}
-		}
-	}
-}
-
-void DtgOperators::free_solution() {
-	if (solution == 0)
-		return;
-	// Freeing memory;
-#ifdef DEBUG_RED_BLACK
-	cout << "=================> Freeing solution for variable " << var << " [" << g_variable_name[var] << "]" << endl;
-#endif
-	for (int val0=0;val0<range;val0++) {
-		delete [] solution[val0];
-	}
-	delete [] solution;
-	solution = 0;
-}
-
-
-void DtgOperators::free_solution_edges_for_root() {
-	if (sol_edges == 0)
-		return;
-	// Freeing memory;
-#ifdef DEBUG_RED_BLACK
-	cout << "=================> Freeing solution edges for variable " << var << " [" << g_variable_name[var] << "]" << endl;
 #endif
-	for (int val0=0;val0<range;val0++) {
-		delete [] sol_edges[val0];
-	}
-	delete [] sol_edges;
-	sol_edges = 0;
+	prepare_shortest_paths_ignore_prevail_conditions();
 }
 
-void DtgOperators::add_edge_to_complete_forward_graph(int from, int to, int op_no, int op_cost, bool no_red_prec) {
-	if (is_red_connected && !ops_sufficient[op_no])
-		return;
-	GraphEdge edge(to, op_no, op_cost, no_red_prec);
-	complete_forward_graph[from].push_back(edge);
-}
-
-void DtgOperators::calculate_shortest_paths_ignore_prevail_conditions() {
+void DtgOperators::prepare_shortest_paths_ignore_prevail_conditions() {
 	if (shortest_paths_calculated)
 		return;
 	shortest_paths_calculated = true;
 
 #ifdef DEBUG_RED_BLACK
-	cout << "=================> Calculating shortest paths in advance for variable " << var << " (" << g_variable_name[var] << ") with domain size " << range << endl;
+	cout << "=================> Preparing lazy shortest paths for variable " << var << " (" << g_variable_name[var] << ") with domain size " << range << endl;
 #endif
+	auto row_memory = 3 * range * sizeof(int);
+	max_cached_targets = std::max<int>(1, std::min<size_t>(range, MAX_PATH_CACHE_MEMORY / row_memory));
+	clear_path_cache();
+	path_cache_row.assign(range, -1);
+}
 
-	// All pairs shortest path
-	solution = new int*[range];
+void DtgOperators::clear_path_cache() {
+	vector<int>().swap(path_cache_row);
+	vector<int>().swap(path_cache_targets);
+	vector<int>().swap(path_cache_distance);
+	vector<int>().swap(path_cache_next_op);
+	vector<int>().swap(path_cache_next_value);
+	path_cache_next_victim = 0;
+}
 
-	for (int val0=0;val0<range;val0++) {  // Initialize
-		solution[val0] = new int[range];
-		for (int val1=0;val1<range;val1++) {
-			if (val0 == val1) {
-				solution[val0][val1] = 0;
-			} else {
-				solution[val0][val1] = numeric_limits<int>::max();
-			}
-		}
-		// Now going over the forward graph, setting the initial values
-		for (int e = 0; e < complete_forward_graph[val0].size(); e++) {
-			// Going over the edges
-			const GraphEdge& edge = complete_forward_graph[val0][e];
-			int to_val = edge.to;
-			assert(to_val >= 0 && to_val < range);
-			solution[val0][to_val] = edge.cost;
-		}
+const int *DtgOperators::get_distances_to(int to) const {
+#ifdef CRITICAL_RED_BLACK
+	if (path_cache_row.empty()) {
+		cout << "Should not be called here! Bug!" << endl;
+		utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
 	}
-
-	for (int k=0;k<range;k++) {
-		for (int i=0;i<range;i++) {
-			if (solution[i][k] == numeric_limits<int>::max())  // In this case, no update is possible
-				continue;
-			for (int j=0;j<range;j++) {
-				if (solution[k][j] == numeric_limits<int>::max())  // In this case, no update is possible
-					continue;
-
-				int new_dist = solution[i][k] + solution[k][j];
-				if (new_dist < solution[i][j]) {
-					// Update
-					solution[i][j] = new_dist;
-				}
+#endif
+	assert(to >= 0 && to < range);
+	if (path_cache_row[to] != -1)
+		return &path_cache_distance[path_cache_row[to] * range];
+
+	// Get a row for the target, replacing the oldest one if the cache is full
+	int row;
+	if (static_cast<int>(path_cache_targets.size()) < max_cached_targets) {
+		row = path_cache_targets.size();
+		path_cache_targets.push_back(to);
+		path_cache_distance.resize(path_cache_distance.size() + range);
+		path_cache_next_op.resize(path_cache_next_op.size() + range);
+		path_cache_next_value.resize(path_cache_next_value.size() + range);
+	} else {
+		row = path_cache_next_victim;
+		path_cache_next_victim = (path_cache_next_victim + 1) % max_cached_targets;
+		path_cache_row[path_cache_targets[row]] = -1;
+		path_cache_targets[row] = to;
+	}
+	path_cache_row[to] = row;
+
+	// Dijkstra from the target on the backward graph
+	int *distance = &path_cache_distance[row * range];
+	int *next_op = &path_cache_next_op[row * range];
+	int *next_value = &path_cache_next_value[row * range];
+	std::fill_n(distance, range, numeric_limits<int>::max());
+	std::fill_n(next_op, range, -1);
+	std::fill_n(next_value, range, -1);
+	priority_queues::AdaptiveQueue<int> queue;
+	distance[to] = 0;
+	queue.push(0, to);
+	while (!queue.empty()) {
+		auto top_pair = queue.pop();
+		int value = top_pair.second;
+		if (top_pair.first > distance[value])
+			continue;
+		for (const GraphEdge& edge : complete_backward_graph[value]) {
+			// here, edge.to is the source of the transition
+			int new_dist = top_pair.first + edge.cost;
+			if (new_dist < distance[edge.to]) {
+				distance[edge.to] = new_dist;
+				next_op[edge.to] = edge.op_no;
+				next_value[edge.to] = value;
+				queue.push(new_dist, edge.to);
 			}
 		}
 	}
-
+	return distance;
 }
 
-int DtgOperators::get_shortest_distance_ignore_prevail_conditions(int from, int to) const {
+void DtgOperators::add_edge_to_complete_forward_graph(int from, int to, int op_no, int op_cost, bool no_red_prec) {
+	if (is_red_connected && !ops_sufficient[op_no])
+		return;
 #ifdef CRITICAL_RED_BLACK
-	if (solution == 0) {
-		cout << "Should not be called here! Bug!" << endl;
-		exit_with(EXIT_CRITICAL_ERROR);
+	if (is_root && !no_red_prec) {
+		cout << "Edge is not initially enabled for the root variable!! Bug!" << endl;
+		utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
 	}
 #endif
+	GraphEdge edge(to, op_no, op_cost, no_red_prec);
+	complete_forward_graph[from].push_back(edge);
+	complete_backward_graph[to].emplace_back(from, op_no, op_cost, no_red_prec);
+}
+
+int DtgOperators::get_shortest_distance_ignore_prevail_conditions(int from, int to) const {
 	assert(from >= 0 && from < range);
 	assert(to >= 0 && to < range);
-	return solution[from][to];
+	return get_distances_to(to)[from];
 }
 
 
@@ -678,27 +639,28 @@ const vector<int>& DtgOperators::get_shortest_path_for_root() {
 }
 
 const vector<int>& DtgOperators::get_shortest_path_for_root_from_to(int from, int to) {
-#ifdef CRITICAL_RED_BLACK
-	if (sol_edges == 0) {
-		cout << "Should not be called here! Bug!" << endl;
-		exit_with(EXIT_CRITICAL_ERROR);
-	}
-#endif
-
 #ifdef DEBUG_RED_BLACK
 	cout << "Getting the shortest path from " << from << " to " << to << endl;
 #endif
 	assert(from >= 0 && from < range);
 	assert(to >= 0 && to < range);
+	plan.clear();
 	if (from == to) {
 		// Nothing to do here, but this method should not be called in this case
 #ifdef DEBUG_RED_BLACK
 	cout << "Warning: should not be called for current == missing" << endl;
 #endif
-		plan.clear();
 		return plan;
 	}
-	return sol_edges[from][to];
+	if (get_distances_to(to)[from] == numeric_limits<int>::max())
+		return plan;
+	// Follow the next transitions of the cached row
+	int row = path_cache_row[to];
+	const int *next_op = &path_cache_next_op[row * range];
+	const int *next_value = &path_cache_next_value[row * range];
+	for (int value = from; value != to; value = next_value[value])
+		plan.push_back(next_op[value]);
+	return plan;
 }
 
 int DtgOperators::get_current_shortest_path_cost() const {
@@ -707,10 +669,11 @@ int DtgOperators::get_current_shortest_path_cost() const {
 
 int DtgOperators::get_current_shortest_path_cost_to(int to) const {
 	if (is_root) {
-		if (solution[current_value][to] == numeric_limits<int>::max()) {
+		int distance = get_distances_to(to)[current_value];
+		if (distance == numeric_limits<int>::max()) {
 			return -1;
 		}
-		return solution[current_value][to];
+		return distance;
 
 	}
 
@@ -718,7 +681,7 @@ int DtgOperators::get_current_shortest_path_cost_to(int to) const {
 #ifdef CRITICAL_RED_BLACK
 	if (dijkstra_distance == 0) {
 		cout << "Should not be called here! Bug!" << endl;
-		exit_with(EXIT_CRITICAL_ERROR);
+		utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
 	}
 #endif
 
@@ -774,7 +737,7 @@ const vector<int>& DtgOperators::calculate_shortest_path_from_to(int from, int t
 	dijkstra_ops[from] = -1;
 	dijkstra_prev[from] = -1;
 
-	queue.push(solution[from][to], from);
+	queue.push(get_distances_to(to)[from], from);
 	astar_search(queue, to);
 
 #ifdef DEBUG_RED_BLACK
@@ -802,12 +765,13 @@ const vector<int> & DtgOperators::calculate_shortest_path_from_to(
 	std::fill_n(dijkstra_distance, range, numeric_limits<int>::max());
 	std::fill_n(dijkstra_tiebreaker, range, numeric_limits<int>::max());
 	priority_queues::AdaptiveQueue<int> queue;
+	const int *distances_to_goal = get_distances_to(to);
 	for (const auto from_val : from) {
 		dijkstra_distance[from_val] = 0;
 		dijkstra_tiebreaker[from_val] = 0;
 		dijkstra_ops[from_val] = -1;
 		dijkstra_prev[from_val] = -1;
-		queue.push(solution[from_val][to], from_val);
+		queue.push(distances_to_goal[from_val], from_val);
 	}
 
 	astar_search(queue, to);
@@ -846,13 +810,14 @@ void DtgOperators::restore_path_from_dijkstra_ops(int to_state, vector<int>& pat
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// A* search using the previously computed solution from current as an admissible estimate. The goal is the missing value
+// A* search using the lazily computed distances to the goal (ignoring prevail conditions) as an admissible estimate. The goal is the missing value
 // dijkstra_distance is used for holding the g values
 // When the
 void DtgOperators::astar_search(priority_queues::AdaptiveQueue<int> &queue, int goal) {
 #ifdef DEBUG_RED_BLACK
 	cout << "Starting A* search!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!" << endl;
 #endif
+	const int *distances_to_goal = get_distances_to(goal);
     while (!queue.empty()) {
         pair<int, int> top_pair = queue.pop();
         int f_val = top_pair.first;
@@ -862,7 +827,7 @@ void DtgOperators::astar_search(priority_queues::AdaptiveQueue<int> &queue, int
         if (state == goal)
         	return;
         assert(g_val <= f_val);
-        if (g_val + solution[state][goal] < f_val)
+        if (g_val + distances_to_goal[state] < f_val)
             continue;
 
 #ifdef DEBUG_RED_BLACK
@@ -895,7 +860,7 @@ void DtgOperators::astar_search(priority_queues::AdaptiveQueue<int> &queue, int
 				dijkstra_tiebreaker[successor] = tie_break_value;
             	dijkstra_ops[successor] = transition.op_no;
             	dijkstra_prev[successor] = state;
-                queue.push(successor_g + solution[successor][goal], successor);
+                queue.push(successor_g + distances_to_goal[successor], successor);
             }
         }
     }
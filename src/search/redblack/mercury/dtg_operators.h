@@ -75,8 +75,17 @@ class DtgOperators {
 	int* dijkstra_ops; // Deleted for red variables after initialization
 	int* dijkstra_prev; // Deleted for red variables after initialization
 
-	vector<int>** sol_edges; // Deleted for red variables after initialization
-	int** solution; // Deleted for all variables after initialization (except for the GREEDY_MINIMIZATION serialization method)
+	// Shortest paths ignoring prevail conditions are computed lazily, one target value at a time (Dijkstra on the backward graph).
+	// For each cached target, the flat arrays store the distance to the target and the next transition on a shortest path from every value.
+	static constexpr size_t MAX_PATH_CACHE_MEMORY = 16 * 1024 * 1024; // in bytes, per variable
+	mutable vector<int> path_cache_row; // row of each target value in the flat arrays, -1 if not cached
+	mutable vector<int> path_cache_targets; // target value of each row
+	mutable vector<int> path_cache_distance;
+	mutable vector<int> path_cache_next_op;
+	mutable vector<int> path_cache_next_value;
+	mutable int path_cache_next_victim;
+	int max_cached_targets;
+	vector<vector<GraphEdge> > complete_backward_graph;  // Deleted for red variables after initialization
 
 	vector<vector<GraphEdge> > complete_forward_graph;  // Deleted for red variables after initialization
 
@@ -89,6 +98,10 @@ class DtgOperators {
 	bool is_red_connected;
 	void restore_path_from_dijkstra_ops(int to_state, vector<int>& path) const;
 
+	// Returns the distances of all values to the given value, computing them if they are not cached
+	const int *get_distances_to(int to) const;
+	void clear_path_cache();
+
 
 	// Used for checking invertibility, once, in the initialization. Not used during the search for heuristic computation.
 	bool is_transition_invertible(int from_value, int to_value) const;
@@ -123,7 +136,7 @@ public:
 	void add_operator_from_to(int from, int to, sas_operator sas_op);
 	bool check_invertibility() const;
 
-	void set_follow_red_facts() { use_sufficient_unachieved = true; }
+	void set_follow_red_facts(bool do_follow_red_facts = true) { use_sufficient_unachieved = do_follow_red_facts; }
 	void set_use_black_reachable(bool do_use_black_reachable = true) { use_black_reachable = do_use_black_reachable; }
 
 	// For delaying the goal achievement
@@ -131,9 +144,10 @@ public:
 
 	// For black variables only
 	void initialize_black(RedBlackDAGFactFollowingHeuristic* base);
-	void calculate_shortest_paths_for_root();
+	bool is_black_initialized() const { return black_initialized; }
+	void prepare_shortest_paths_for_root();
 
-	void calculate_shortest_paths_ignore_prevail_conditions();
+	void prepare_shortest_paths_ignore_prevail_conditions();
 	void add_edge_to_complete_forward_graph(int from, int to, int op_no, int op_cost, bool no_red_prec);
 
 	//////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -181,15 +195,13 @@ public:
 	int get_current_value() const { return current_value; }
 	int get_missing_value() const { return missing_value; }
 	int get_shortest_distance_ignore_prevail_conditions(int from, int to) const;
-	void set_red_connected() { is_red_connected = true; }
+	void set_red_connected(bool red_connected = true) { is_red_connected = red_connected; }
 
 
 	int get_cost_of_resolving_conflict(int to) const {
 		// Return the cost of getting from the current value to the desired value
 		return get_shortest_distance_ignore_prevail_conditions(get_current_value(), to);
 	}
-	void free_solution();
-	void free_solution_edges_for_root();
 	void set_goal_val(int val) { goal_val = val; }
 
 	void set_only_current_transitions(bool curr) { only_current_transitions = curr; }
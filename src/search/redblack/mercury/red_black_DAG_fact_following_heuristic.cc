@@ -21,19 +21,22 @@ using namespace std;
 
 RedBlackDAGFactFollowingHeuristic::RedBlackDAGFactFollowingHeuristic(const Options &opts)
     : additive_heuristic::AdditiveHeuristic<GlobalState, GlobalOperator>(opts), extract_plan(opts.get<bool>("extract_plan")), solution_found(false), suffix_plan(), applicability_status(false)
-	, num_invertible_vars(0), shortest_paths_calculated(false), use_black_dag(false), current_outside_red_variables(nullptr) {
+	, num_invertible_vars(0), shortest_paths_calculated(false), use_black_dag(false), current_outside_red_variables(nullptr), num_black_dag_edges(0), num_almost_roots(0), num_semi_relaxed_plans(0), semi_relaxed_plan_time(0)
+	, semi_relaxed_plan_cache_size(opts.get<int>("semi_relaxed_plan_cache_size")), num_semi_relaxed_plan_cache_lookups(0), num_semi_relaxed_plan_cache_hits(0) {
 	ignore_invertibility = opts.get<bool>("ignore_invertibility");
 	preferred_type = PreferredOpsType(opts.get_enum("prefs"));
 
 	paint_roots_black = opts.get<bool>("paint_roots_black");
 
+	bitset_semi_relaxed_state = opts.get<bool>("bitset_semi_relaxed_state");
+
 	applicable_paths_first = opts.get<bool>("applicable_paths_first");
 	if (applicable_paths_first)
-		black_state_buffer = std::vector<std::vector<int>>(g_root_task()->get_num_variables());
+		black_state_buffer = SemiRelaxedState(g_variable_domain, bitset_semi_relaxed_state);
 
 	use_connected = opts.get<bool>("use_connected");
 	if (use_connected)
-		connected_state_buffer = std::vector<std::vector<int>>(g_root_task()->get_num_variables());
+		connected_state_buffer = SemiRelaxedState(g_variable_domain, bitset_semi_relaxed_state);
 
 	next_red_action_test = opts.get<bool>("next_red_action_test");
 
@@ -68,7 +71,7 @@ void RedBlackDAGFactFollowingHeuristic::initialize() {
 
 	// copied from Michael
 	if (extract_plan) {
-		curr_state_buffer.resize(g_variable_domain.size());
+		curr_state_buffer = SemiRelaxedState(g_variable_domain, bitset_semi_relaxed_state);
 	}
 
 
@@ -163,6 +166,7 @@ void RedBlackDAGFactFollowingHeuristic::initialize() {
 
     // Precalculating black paths/values (in case it was not done before)
     precalculate_variables();
+    prepare_incremental_repainting();
     std::cout << "Finished initializing Red-Black Relaxation heuristic at time step [t=" << utils::g_timer << "]" << endl;
 }
 
@@ -253,7 +257,7 @@ auto RedBlackDAGFactFollowingHeuristic::ff_compute_heuristic(const GlobalState &
     if (extract_plan) {
     	// Added check for applicability of the found plan
     	for (size_t i = 0; i < g_variable_domain.size(); i++) {
-			curr_state_buffer[i] = {state[i]};
+			curr_state_buffer.set(i, state[i]);
     	}
         apply_while_possible();
     }
@@ -834,7 +838,7 @@ void RedBlackDAGFactFollowingHeuristic::precalculate_variables() {
         }
     }
 
-    cout << "Precalculating all pair shortest paths" << endl;
+    cout << "Preparing lazily computed shortest paths" << endl;
     for (int var = 0; var < g_variable_domain.size(); var++) {
     	precalculate_shortest_paths_for_var(var);
     }
@@ -849,10 +853,9 @@ void RedBlackDAGFactFollowingHeuristic::precalculate_shortest_paths_for_var(int
     if (!black_vars[var] && use_connected) {
     	cout << "Storing shortest paths and costs for connected red variable " << var << endl;
     	if (get_cg_predecessors(var).size() == 0) {
-    		get_dtg(var)->calculate_shortest_paths_for_root();
+    		get_dtg(var)->prepare_shortest_paths_for_root();
     	}else {
-    		// TODO: Think of some smarter way of implementing that
-    		get_dtg(var)->calculate_shortest_paths_ignore_prevail_conditions();
+    		get_dtg(var)->prepare_shortest_paths_ignore_prevail_conditions();
     	}
     }
 
@@ -861,14 +864,14 @@ void RedBlackDAGFactFollowingHeuristic::precalculate_shortest_paths_for_var(int
 
     if (get_cg_predecessors(var).size() == 0) {
 //    	cout << "Storing shortest paths and costs for root variable " << var << endl;
-		get_dtg(var)->calculate_shortest_paths_for_root();
+		get_dtg(var)->prepare_shortest_paths_for_root();
     	return;
     }
 
-	// Storing shortest paths ignoring external preconditions for all black variables
+	// Shortest paths ignoring external preconditions are computed on demand for all black variables
 	// Since it is already done for the root variables, skipping them here
 //	cout << "Storing shortest paths costs ignoring external preconditions for variable " << var << endl;
-	get_dtg(var)->calculate_shortest_paths_ignore_prevail_conditions();
+	get_dtg(var)->prepare_shortest_paths_ignore_prevail_conditions();
 }
 
 
@@ -1582,8 +1585,7 @@ const vector<int>& RedBlackDAGFactFollowingHeuristic::get_path_for_var(int var)
 	// Extending the obtained sequence into an actual plan
 	current_applicable_sequence.clear();
 	// Copying the current state
-	for (int i = 0; i < g_variable_domain.size(); i++)
-		connected_state_buffer[i] = curr_state_buffer[i];
+	connected_state_buffer = curr_state_buffer;
 	//	get_rb_sas_operator(op_no)->apply(curr_state_buffer);
 
 	for (int i = 0; i < ops.size(); i++) {
@@ -1600,14 +1602,13 @@ const vector<int>& RedBlackDAGFactFollowingHeuristic::get_path_for_var(int var)
 	    	int pre_var = (*it).first;
 
 			// Adding the sequence of values that moves the red connected var to its precondition
-			const std::vector<int> &from_vals = connected_state_buffer[pre_var];
 			int to_val = (*it).second;
+			if (connected_state_buffer.contains(pre_var, to_val))
+				continue;
+			const std::vector<int> &from_vals = connected_state_buffer.get_values(pre_var);
 #ifdef DEBUG_RED_BLACK
-			cout << "Current red value is " << from_val << " and the needed value is " << to_val << endl;
+			cout << "Current red values are " << from_vals.size() << " values and the needed value is " << to_val << endl;
 #endif
-			assert(std::is_sorted(std::begin(from_vals), std::end(from_vals)));
-			if (std::binary_search(std::begin(from_vals), std::end(from_vals), to_val))
-				continue;
 
 #ifdef DEBUG_RED_BLACK
 			cout << "Getting the shortest path for the red var." << endl;
@@ -1622,12 +1623,9 @@ const vector<int>& RedBlackDAGFactFollowingHeuristic::get_path_for_var(int var)
 			}
 #endif
 			if (!current_outside_red_variables || !current_outside_red_variables->at(pre_var)) {
-				connected_state_buffer[pre_var] = {to_val};
+				connected_state_buffer.set(pre_var, to_val);
 			} else {
-				connected_state_buffer[pre_var].push_back(to_val);
-				std::inplace_merge(std::begin(connected_state_buffer[pre_var]),
-				                   std::end(connected_state_buffer[pre_var]) - 1,
-				                   std::end(connected_state_buffer[pre_var]));
+				connected_state_buffer.add(pre_var, to_val);
 			}
 #ifdef DEBUG_RED_BLACK
 			cout << "Pushing the path to the end of the sequence." << endl;
@@ -1929,11 +1927,67 @@ auto RedBlackDAGFactFollowingHeuristic::compute_semi_relaxed_plan(const GlobalSt
 	return compute_semi_relaxed_plan(state.get_values(), goal_facts, base_relaxed_plan, legal_operators);
 }
 
+auto RedBlackDAGFactFollowingHeuristic::get_semi_relaxed_plan_cache_key(std::vector<int> state_key, const std::vector<FactPair> &goal_facts, const std::vector<OperatorID> &base_relaxed_plan, const boost::dynamic_bitset<> &legal_operators) const -> SemiRelaxedPlanCacheKey {
+	auto &key = state_key;
+	key.reserve(key.size() + 2 * goal_facts.size() + base_relaxed_plan.size() + black_indices.size() + red_indices.size() + 5);
+	key.push_back(goal_facts.size());
+	for (const auto &goal_fact : goal_facts) {
+		key.push_back(goal_fact.var);
+		key.push_back(goal_fact.value);
+	}
+	key.push_back(base_relaxed_plan.size());
+	for (const auto op : base_relaxed_plan)
+		key.push_back(op.get_index());
+	// the order of the black and red variables determines the order in which the heuristic processes them
+	key.push_back(black_indices.size());
+	key.insert(std::end(key), std::begin(black_indices), std::end(black_indices));
+	key.push_back(red_indices.size());
+	key.insert(std::end(key), std::begin(red_indices), std::end(red_indices));
+	key.push_back(use_connected);
+	auto blocks = std::vector<boost::dynamic_bitset<>::block_type>();
+	blocks.reserve(legal_operators.num_blocks());
+	boost::to_block_range(legal_operators, std::back_inserter(blocks));
+	return {std::move(key), std::move(blocks)};
+}
+
+auto RedBlackDAGFactFollowingHeuristic::lookup_semi_relaxed_plan(const SemiRelaxedPlanCacheKey &key) -> const SemiRelaxedPlan * {
+	++num_semi_relaxed_plan_cache_lookups;
+	auto it = semi_relaxed_plan_cache.find(key);
+	if (it == std::end(semi_relaxed_plan_cache))
+		return nullptr;
+	++num_semi_relaxed_plan_cache_hits;
+	return &it->second;
+}
+
+void RedBlackDAGFactFollowingHeuristic::store_semi_relaxed_plan(SemiRelaxedPlanCacheKey &&key, const SemiRelaxedPlan &plan) {
+	// start over when the cache is full, most hits come from recently converging paths anyway
+	if (static_cast<int>(semi_relaxed_plan_cache.size()) >= semi_relaxed_plan_cache_size)
+		semi_relaxed_plan_cache.clear();
+	semi_relaxed_plan_cache.emplace(std::move(key), plan);
+}
+
 auto RedBlackDAGFactFollowingHeuristic::compute_semi_relaxed_plan(const std::vector<int> &state_values, const std::vector<FactPair> &goal_facts, const std::vector<OperatorID> &base_relaxed_plan, const boost::dynamic_bitset<> &legal_operators) -> std::pair<bool, std::vector<OperatorID>> {
 	if (std::all_of(std::begin(goal_facts), std::end(goal_facts), [&state_values](const auto &goal) { return state_values[goal.var] == goal.value; }))
 		return {true, {}};
+	if (semi_relaxed_plan_cache_size == 0)
+		return compute_semi_relaxed_plan_uncached(state_values, goal_facts, base_relaxed_plan, legal_operators);
+	auto state_key = std::vector<int>();
+	state_key.reserve(state_values.size() + 1);
+	state_key.push_back(0);
+	state_key.insert(std::end(state_key), std::begin(state_values), std::end(state_values));
+	auto key = get_semi_relaxed_plan_cache_key(std::move(state_key), goal_facts, base_relaxed_plan, legal_operators);
+	if (const auto *cached_plan = lookup_semi_relaxed_plan(key))
+		return *cached_plan;
+	auto plan = compute_semi_relaxed_plan_uncached(state_values, goal_facts, base_relaxed_plan, legal_operators);
+	store_semi_relaxed_plan(std::move(key), plan);
+	return plan;
+}
+
+auto RedBlackDAGFactFollowingHeuristic::compute_semi_relaxed_plan_uncached(const std::vector<int> &state_values, const std::vector<FactPair> &goal_facts, const std::vector<OperatorID> &base_relaxed_plan, const boost::dynamic_bitset<> &legal_operators) -> SemiRelaxedPlan {
 	assert(black_indices.size() > 0);
 	assert(extract_plan);
+	utils::Timer timer;
+	++num_semi_relaxed_plans;
 
 	current_legal_operators = legal_operators;
 
@@ -1948,7 +2002,7 @@ auto RedBlackDAGFactFollowingHeuristic::compute_semi_relaxed_plan(const std::vec
 		solution_found = false;
 
 		for (int i = 0; i < g_variable_domain.size(); i++)
-			curr_state_buffer[i] = { state_values[i]};
+			curr_state_buffer.set(i, state_values[i]);
 	}
 
 	reset_all_marks(goal_facts);
@@ -1965,11 +2019,13 @@ auto RedBlackDAGFactFollowingHeuristic::compute_semi_relaxed_plan(const std::vec
 		std::transform(std::begin(suffix_plan), std::end(suffix_plan), std::back_inserter(fixed_plan), [](const auto op) { return OperatorID(get_op_index_hacked(op)); });
 		// Clearing the marking for the next state computation
 		remove_all_operators_from_parallel_relaxed_plan();
+		semi_relaxed_plan_time += timer();
 
 		return {true, fixed_plan};
 	}
 	// Clearing the marking for the next state computation
 	remove_all_operators_from_parallel_relaxed_plan();
+	semi_relaxed_plan_time += timer();
 
 	return {false, {}};
 }
@@ -1985,8 +2041,35 @@ OperatorID>> {
 	if (std::all_of(std::begin(goal_facts), std::end(goal_facts), [&available_facts](const auto &goal_fact) {
 		return std::binary_search(std::begin(available_facts), std::end(available_facts), goal_fact); }))
 		return {true, {}};
+	if (semi_relaxed_plan_cache_size == 0)
+		return compute_semi_relaxed_plan_uncached(available_facts, outside_red_variables, goal_facts, base_relaxed_plan, legal_operators);
+	auto state_key = std::vector<int>();
+	state_key.reserve(2 * available_facts.size() + outside_red_variables.size() + 2);
+	state_key.push_back(1);
+	state_key.push_back(available_facts.size());
+	for (const auto &fact : available_facts) {
+		state_key.push_back(fact.var);
+		state_key.push_back(fact.value);
+	}
+	state_key.insert(std::end(state_key), std::begin(outside_red_variables), std::end(outside_red_variables));
+	auto key = get_semi_relaxed_plan_cache_key(std::move(state_key), goal_facts, base_relaxed_plan, legal_operators);
+	if (const auto *cached_plan = lookup_semi_relaxed_plan(key))
+		return *cached_plan;
+	auto plan = compute_semi_relaxed_plan_uncached(available_facts, outside_red_variables, goal_facts, base_relaxed_plan, legal_operators);
+	store_semi_relaxed_plan(std::move(key), plan);
+	return plan;
+}
+
+auto RedBlackDAGFactFollowingHeuristic::compute_semi_relaxed_plan_uncached(
+	const std::vector<FactPair> &available_facts,
+	const std::vector<bool> &outside_red_variables,
+	const std::vector<FactPair> &goal_facts,
+	const std::vector<OperatorID> &base_relaxed_plan,
+	const boost::dynamic_bitset<> &legal_operators) -> SemiRelaxedPlan {
 	assert(black_indices.size() > 0);
 	assert(extract_plan);
+	utils::Timer timer;
+	++num_semi_relaxed_plans;
 
 	current_outside_red_variables = &outside_red_variables;
 	current_legal_operators = legal_operators;
@@ -2001,15 +2084,13 @@ OperatorID>> {
 		suffix_plan.clear();
 		solution_found = false;
 
-		for (auto &buffer : curr_state_buffer)
-			buffer.clear();
-	
+		curr_state_buffer.clear();
 		for (const auto &fact : available_facts)
-			curr_state_buffer[fact.var].push_back(fact.value);
+			curr_state_buffer.add(fact.var, fact.value);
 #ifndef NDEBUG
 		for (auto var = 0; var < g_root_task()->get_num_variables(); ++var) {
-			assert(!curr_state_buffer[var].empty());
-			assert(outside_red_variables[var] || curr_state_buffer[var].size() == 1);
+			assert(curr_state_buffer.count(var) > 0);
+			assert(outside_red_variables[var] || curr_state_buffer.count(var) == 1);
 		}
 #endif
 
@@ -2030,12 +2111,14 @@ OperatorID>> {
 		// Clearing the marking for the next state computation
 		remove_all_operators_from_parallel_relaxed_plan();
 		current_outside_red_variables = nullptr;
+		semi_relaxed_plan_time += timer();
 
 		return {true, fixed_plan};
 	}
 	// Clearing the marking for the next state computation
 	remove_all_operators_from_parallel_relaxed_plan();
 	current_outside_red_variables = nullptr;
+	semi_relaxed_plan_time += timer();
 
 	return {false, {}};
 }
@@ -2069,7 +2152,7 @@ int RedBlackDAGFactFollowingHeuristic::compute_heuristic(const GlobalState &stat
     	solution_found = false;
 
     	for (int i = 0; i < g_variable_domain.size(); i++)
-			curr_state_buffer[i] = {state[i]};
+			curr_state_buffer.set(i, state[i]);
     }
     // Removing the empty layers, for faster future computation (hopefully). Need to check!!!
     for (int i=parallel_relaxed_plan.size()-1; i >= 0; i--) {
@@ -2112,82 +2195,157 @@ int RedBlackDAGFactFollowingHeuristic::compute_heuristic(const GlobalState &stat
     return res;
 }
 
-void RedBlackDAGFactFollowingHeuristic::make_red(std::vector<int> variables) {
-	for (auto black_var : variables) {
-		assert(black_vars[black_var]);
-		black_vars[black_var] = false;
-		get_dtg(black_var)->set_use_black_reachable(false);
-		black_indices.erase(std::find(std::begin(black_indices), std::end(black_indices), black_var));
-		red_indices.push_back(black_var);
+void RedBlackDAGFactFollowingHeuristic::prepare_incremental_repainting() {
+	ops_by_precondition_var.assign(g_variable_domain.size(), vector<int>());
+	ops_by_effect_var.assign(g_variable_domain.size(), vector<int>());
+	for (int op_no = 0; op_no < g_operators.size(); op_no++) {
+		for (const auto &precondition : g_operators[op_no].get_preconditions())
+			ops_by_precondition_var[precondition.var].push_back(op_no);
+		for (const auto &effect : g_operators[op_no].get_effects())
+			ops_by_effect_var[effect.var].push_back(op_no);
 	}
 
-	// recompute use_black_dag
-	use_black_dag = false;
-	for (int i = 0; i < black_indices.size(); i++) {
-		int var = black_indices[i];
-		//		black_dag_edges[var].assign(g_variable_domain.size(), false);
-		const vector<int>& succ = get_cg_successors(var);
-
-		for (int j = 0; j < succ.size(); j++) {
-			int to_var = succ[j];
-			if (black_vars[to_var]) {
-				use_black_dag = true;
-				//				black_dag_edges[var][to_var] = true;
-			}
-		}
+	num_black_dag_edges = 0;
+	for (int var : black_indices)
+		for (int to_var : get_cg_successors(var))
+			if (black_vars[to_var])
+				num_black_dag_edges++;
+	assert(use_black_dag == (num_black_dag_edges > 0));
+
+	num_almost_roots = std::count(std::begin(almost_roots), std::end(almost_roots), true);
+}
+
+void RedBlackDAGFactFollowingHeuristic::update_almost_root(int var) {
+	bool almost_root = false;
+	const vector<int> &pred = get_cg_predecessors(var);
+	if (black_vars[var] && pred.size() > 0) {
+		almost_root = std::none_of(std::begin(pred), std::end(pred), [this](int pred_var) {
+			return black_vars[pred_var] || connectivity_status[pred_var] != ALL_PAIRS_CONNECTED;
+		});
+	}
+	if (almost_root != almost_roots[var]) {
+		almost_roots[var] = almost_root;
+		num_almost_roots += almost_root ? 1 : -1;
+	}
+}
+
+void RedBlackDAGFactFollowingHeuristic::repaint_variable(int var, bool black) {
+	assert(black_vars[var] != black);
+	assert(!black || get_dtg(var)->is_black_initialized());
+
+	int num_black_neighbour_edges = 0;
+	for (int to_var : get_cg_successors(var))
+		if (black_vars[to_var])
+			num_black_neighbour_edges++;
+	for (int from_var : get_cg_predecessors(var))
+		if (black_vars[from_var])
+			num_black_neighbour_edges++;
+	num_black_dag_edges += black ? num_black_neighbour_edges : -num_black_neighbour_edges;
+
+	black_vars[var] = black;
+	auto &from_indices = black ? red_indices : black_indices;
+	auto &to_indices = black ? black_indices : red_indices;
+	from_indices.erase(std::find(std::begin(from_indices), std::end(from_indices), var));
+	to_indices.push_back(var);
+
+	// Operators with a precondition or effect on var
+	for (int op_no : ops_by_precondition_var[var])
+		get_rb_sas_operator(op_no)->set_variable_color(var, black);
+	for (int op_no : ops_by_effect_var[var])
+		get_rb_sas_operator(op_no)->set_variable_color(var, black);
+	if (black) {
+		vector<vector<int> >().swap(ops_by_pre[var]);
+		vector<vector<int> >().swap(ops_by_eff[var]);
+	} else {
+		ops_by_pre[var].assign(g_variable_domain[var], vector<int>());
+		for (int op_no : ops_by_precondition_var[var])
+			ops_by_pre[var][get_precondition_for_variable(g_operators[op_no], var)].push_back(op_no);
+		ops_by_eff[var].assign(g_variable_domain[var], vector<int>());
+		for (int op_no : ops_by_effect_var[var])
+			for (const auto &effect : g_operators[op_no].get_effects())
+				if (effect.var == var)
+					ops_by_eff[var][effect.val].push_back(op_no);
+	}
+
+	get_dtg(var)->set_use_black_reachable(black);
+	get_dtg(var)->set_follow_red_facts(!black);
+	if (black) {
+		get_dtg(var)->set_red_connected(false);
+		get_dtg(var)->set_only_current_transitions(false);
 	}
 
-	almost_roots.assign(g_variable_domain.size(), false);
-	bool connected_black = false;
-	for (int ind = 0; ind < black_indices.size(); ind++) {
-		int var = black_indices[ind];
-		const vector<int> &pred = get_cg_predecessors(var);
+	update_almost_root(var);
+	for (int to_var : get_cg_successors(var))
+		update_almost_root(to_var);
+}
 
-		if (pred.size() > 0) {
-			almost_roots[var] = true;
-			for (int i = 0; i < pred.size(); i++) {
-				int pred_var = pred[i];
-				if (black_vars[pred_var] || connectivity_status[pred_var] != ALL_PAIRS_CONNECTED) {
-					almost_roots[var] = false;
-					break;
-				}
-			}
+void RedBlackDAGFactFollowingHeuristic::update_repainted_operators(const vector<int> &variables) {
+	// The black successors change for the operators affecting a repainted variable,
+	// and for the operators achieving a red precondition of those
+	vector<int> affected_ops;
+	vector<assignment> red_preconditions;
+	for (int var : variables) {
+		for (int op_no : ops_by_effect_var[var]) {
+			affected_ops.push_back(op_no);
+			const partial_assignment& red_pre = get_rb_sas_operator(op_no)->get_red_precondition();
+			red_preconditions.insert(red_preconditions.end(), red_pre.begin(), red_pre.end());
 		}
-		if (almost_roots[var])
-			connected_black = true;
 	}
-	if (!connected_black)
-		use_connected = false;
+	std::sort(std::begin(red_preconditions), std::end(red_preconditions));
+	red_preconditions.erase(std::unique(std::begin(red_preconditions), std::end(red_preconditions)), std::end(red_preconditions));
+	for (const auto &fact : red_preconditions) {
+		const vector<int> &achievers = ops_by_eff[fact.first][fact.second];
+		affected_ops.insert(affected_ops.end(), achievers.begin(), achievers.end());
+	}
+	std::sort(std::begin(affected_ops), std::end(affected_ops));
+	affected_ops.erase(std::unique(std::begin(affected_ops), std::end(affected_ops)), std::end(affected_ops));
+	for (int op_no : affected_ops)
+		set_black_successors_for_op(op_no);
 
-	if (use_connected) {
-		// Setting the red variables
-		for (int ind = 0; ind < red_indices.size(); ind++) {
-			int var = red_indices[ind];
-			if (connectivity_status[var] == ALL_PAIRS_CONNECTED) {
-				get_dtg(var)->set_red_connected();
-				// Used only for finding actual plans
-				get_dtg(var)->set_only_current_transitions(true);
-			}
+	if (!next_red_action_test)
+		return;
+	vector<int> affected_black_vars;
+	for (int var : variables) {
+		if (black_vars[var])
+			affected_black_vars.push_back(var);
+		else
+			black_var_deletes[var].clear();
+		for (int op_no : ops_by_effect_var[var]) {
+			const partial_assignment& black_eff = get_rb_sas_operator(op_no)->get_black_effect();
+			for (partial_assignment::iterator it = black_eff.begin(); it != black_eff.end(); ++it)
+				affected_black_vars.push_back((*it).first);
 		}
 	}
+	std::sort(std::begin(affected_black_vars), std::end(affected_black_vars));
+	affected_black_vars.erase(std::unique(std::begin(affected_black_vars), std::end(affected_black_vars)), std::end(affected_black_vars));
+	for (int var : affected_black_vars)
+		set_black_var_deletes_for_var(var);
+}
 
-	assert(!black_indices.empty());
-
-	// Removing unnecessary data after blacks are set
-	free_red_data();
+void RedBlackDAGFactFollowingHeuristic::update_red_connected_variables(const vector<int> &variables) {
+	if (!use_connected)
+		return;
+	for (int var : variables) {
+		if (!black_vars[var] && connectivity_status[var] == ALL_PAIRS_CONNECTED) {
+			get_dtg(var)->set_red_connected();
+			// Used only for finding actual plans
+			get_dtg(var)->set_only_current_transitions(true);
+		}
+	}
+}
 
-	// reset operators
-	for (auto op_index = 0u; op_index < g_operators.size(); ++op_index)
-		get_rb_sas_operator(op_index)->reset();
+void RedBlackDAGFactFollowingHeuristic::make_red(std::vector<int> variables) {
+	// Only the data of the repainted variables and the operators affecting them is updated.
+	for (auto black_var : variables)
+		repaint_variable(black_var, false);
+	update_repainted_operators(variables);
 
-	// Here we store the operators for counting achieved red preconditions
-	// We can skip the black variables here, since we check only for red preconditions
-	// Also counting the red preconditions for future applicability test of labels in dijkstra.
-	prepare_operators_for_counting_achieved_preconditions();
-	prepare_for_red_fact_following();
+	use_black_dag = num_black_dag_edges > 0;
+	if (num_almost_roots == 0)
+		use_connected = false;
+	update_red_connected_variables(variables);
 
-	// Precalculating black paths/values (in case it was not done before)
-	precalculate_variables();
+	assert(!black_indices.empty());
 }
 
 void RedBlackDAGFactFollowingHeuristic::add_options_to_parser(OptionParser &parser) {
@@ -2212,6 +2370,8 @@ void RedBlackDAGFactFollowingHeuristic::add_options_to_parser(OptionParser &pars
     parser.add_option<bool>("applicable_paths_first", "false");
     parser.add_option<bool>("next_red_action_test", "false");
     parser.add_option<bool>("use_connected", "false");
+    parser.add_option<bool>("bitset_semi_relaxed_state", "store the semi-relaxed states as bitsets instead of sorted value lists", "true");
+    parser.add_option<int>("semi_relaxed_plan_cache_size", "maximum number of cached semi-relaxed plans (0 disables the cache)", "10000", Bounds("0", "infinity"));
 
     // Extracting plan if FF is used
 	parser.add_option<bool>("extract_plan_no_blacks", "false",
@@ -2304,6 +2464,22 @@ void RedBlackDAGFactFollowingHeuristic::prepare_for_red_fact_following() {
 	}
 }
 
+void RedBlackDAGFactFollowingHeuristic::set_black_var_deletes_for_var(int black_var) {
+	// Same as in prepare_for_red_fact_following, restricted to the operators with an effect on black_var
+	black_var_deletes[black_var].clear();
+	for (int op_no : ops_by_effect_var[black_var]) {
+		const vector<GlobalEffect> &effects = g_operators[op_no].get_effects();
+		for (size_t i = 0; i < effects.size(); i++) {
+			int var = effects[i].var;
+			if (black_vars[var])
+				continue;
+			int pre_value = get_precondition_for_variable(g_operators[op_no], var);
+			if (pre_value != -1)
+				black_var_deletes[black_var].insert(make_pair(var, pre_value));
+		}
+	}
+}
+
 
 void RedBlackDAGFactFollowingHeuristic::update_marks() {
 
@@ -2360,23 +2536,27 @@ void RedBlackDAGFactFollowingHeuristic::set_black_successors_by_ops() {
 	// Should be run after ops_by_pre are set
 	blacks_by_ops.assign(g_operators.size(), vector<int>());
 	for (int op_no=0; op_no < g_operators.size(); op_no++) {
-		set<int> black_variables;
-		const partial_assignment& red_eff = get_rb_sas_operator(op_no)->get_red_effect();
-	    for (partial_assignment::iterator it = red_eff.begin(); it != red_eff.end(); ++it) {
-			int var = (*it).first;
-			int val = (*it).second;
+		set_black_successors_for_op(op_no);
+	}
+}
 
-			const vector<int>& ops = get_ops_by_pre(var, val);
-			// Going over all these operators and collecting their black effect vars
-			for (int i=0; i < ops.size(); i++) {
-				const partial_assignment& black_eff = get_rb_sas_operator(ops[i])->get_black_effect();
-			    for (partial_assignment::iterator it2 = black_eff.begin(); it2 != black_eff.end(); ++it2) {
-			    	black_variables.insert((*it2).first);
-			    }
+void RedBlackDAGFactFollowingHeuristic::set_black_successors_for_op(int op_no) {
+	set<int> black_variables;
+	const partial_assignment& red_eff = get_rb_sas_operator(op_no)->get_red_effect();
+	for (partial_assignment::iterator it = red_eff.begin(); it != red_eff.end(); ++it) {
+		int var = (*it).first;
+		int val = (*it).second;
+
+		const vector<int>& ops = get_ops_by_pre(var, val);
+		// Going over all these operators and collecting their black effect vars
+		for (int i=0; i < ops.size(); i++) {
+			const partial_assignment& black_eff = get_rb_sas_operator(ops[i])->get_black_effect();
+			for (partial_assignment::iterator it2 = black_eff.begin(); it2 != black_eff.end(); ++it2) {
+				black_variables.insert((*it2).first);
 			}
-	    }
-	    blacks_by_ops[op_no].insert(blacks_by_ops[op_no].begin(), black_variables.begin(), black_variables.end());
+		}
 	}
+	blacks_by_ops[op_no].assign(black_variables.begin(), black_variables.end());
 }
 
 
@@ -2440,8 +2620,7 @@ bool RedBlackDAGFactFollowingHeuristic::is_currently_applicable(const vector<int
 	}
 
 	// Copying the buffer from curr_state_buffer, applying actions
-	for (int i = 0; i < g_variable_domain.size(); i++)
-		black_state_buffer[i] = curr_state_buffer[i];
+	black_state_buffer = curr_state_buffer;
 
 	for (int i = 1; i < ops.size(); i++) {
 		// Checking the previous action and applying if applicable
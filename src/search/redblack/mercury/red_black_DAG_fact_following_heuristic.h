@@ -16,7 +16,9 @@ using namespace std;
 #include "../operator.h"
 #include "dtg_operators.h"
 #include "red_black_operator.h"
+#include "semi_relaxed_state.h"
 #include "../../task_utils/causal_graph.h"
+#include "../../utils/hash.h"
 
 #ifdef __GNUC__
 #pragma GCC diagnostic push
@@ -44,17 +46,16 @@ class RedBlackDAGFactFollowingHeuristic : public additive_heuristic::AdditiveHeu
 	ParallelRelaxedPlan parallel_relaxed_plan;
 
 	// Patrick: copied from Michael: For checking overall applicability
-	std::vector<std::vector<int>> curr_state_buffer;
+	SemiRelaxedState curr_state_buffer;
 	bool applicability_status;
 	bool solution_found;
 	bool extract_plan;
 
 	const std::vector<bool> *current_outside_red_variables;
 
-	bool test_goal_for_int_vector(const std::vector<std::vector<int>>& state, const std::vector<FactPair> &goal) {
+	bool test_goal_for_int_vector(const SemiRelaxedState& state, const std::vector<FactPair> &goal) {
 		for (size_t i = 0; i < goal.size(); ++i) {
-			assert(std::is_sorted(std::begin(state[goal[i].var]), std::end(state[goal[i].var])));
-			if (!std::binary_search(std::begin(state[goal[i].var]), std::end(state[goal[i].var]), goal[i].value))
+			if (!state.contains(goal[i].var, goal[i].value))
 				return false;
 		}
 		return true;
@@ -66,27 +67,21 @@ class RedBlackDAGFactFollowingHeuristic : public additive_heuristic::AdditiveHeu
 			solution_found = true;
 		}
 	}
-	bool is_op_applicable(const GlobalOperator *op, const std::vector<std::vector<int>>& state) const {
+	bool is_op_applicable(const GlobalOperator *op, const SemiRelaxedState& state) const {
 		for (size_t i = 0; i < op->get_preconditions().size(); ++i) {
 			const GlobalCondition &precondition = op->get_preconditions()[i];
 			// return false if not applicable
-			if (!std::binary_search(std::begin(state[precondition.var]), std::end(state[precondition.var]), precondition.val))
+			if (!state.contains(precondition.var, precondition.val))
 				return false;
 		}
 		return true;
 	}
-	void apply_op(const GlobalOperator *op, std::vector<std::vector<int>>& state) const {
+	void apply_op(const GlobalOperator *op, SemiRelaxedState& state) const {
 		for (size_t i = 0; i < op->get_effects().size(); i++) {
 			if (!current_outside_red_variables || !current_outside_red_variables->at(op->get_effects()[i].var) || black_vars[op->get_effects()[i].var]) {
-				state[op->get_effects()[i].var] = {op->get_effects()[i].val};
+				state.set(op->get_effects()[i].var, op->get_effects()[i].val);
 			} else {
-				if (!std::binary_search(std::begin(state[op->get_effects()[i].var]),
-				                        std::end(state[op->get_effects()[i].var]), op->get_effects()[i].val)) {
-					state[op->get_effects()[i].var].push_back(op->get_effects()[i].val);
-					std::inplace_merge(std::begin(state[op->get_effects()[i].var]),
-					                   std::end(state[op->get_effects()[i].var]) - 1,
-					                   std::end(state[op->get_effects()[i].var]));
-				}
+				state.add(op->get_effects()[i].var, op->get_effects()[i].val);
 			}
 		}
 	}
@@ -116,11 +111,12 @@ class RedBlackDAGFactFollowingHeuristic : public additive_heuristic::AdditiveHeu
 	bool extract_plan_no_blacks;
 
 	bool applicable_paths_first; // Try to find applicable paths for black variables
+	bool bitset_semi_relaxed_state;
 
 	bool next_red_action_test;
 	bool use_connected;
-	std::vector<std::vector<int>> connected_state_buffer;
-	std::vector<std::vector<int>> black_state_buffer;
+	SemiRelaxedState connected_state_buffer;
+	SemiRelaxedState black_state_buffer;
 
 	// Keeping operators by pre for red variables only.
 	vector<vector<vector<int> > > ops_by_pre;
@@ -201,6 +197,36 @@ class RedBlackDAGFactFollowingHeuristic : public additive_heuristic::AdditiveHeu
 
 	void keep_operators_by_effects();
 	void set_black_successors_by_ops();
+	void set_black_successors_for_op(int op_no);
+	void set_black_var_deletes_for_var(int var);
+
+	// For repainting incrementally: operators with a precondition/effect on each variable, and the painting-dependent counters
+	vector<vector<int> > ops_by_precondition_var;
+	vector<vector<int> > ops_by_effect_var;
+	int num_black_dag_edges;
+	int num_almost_roots;
+	void prepare_incremental_repainting();
+	void update_almost_root(int var);
+	void repaint_variable(int var, bool black);
+	void update_repainted_operators(const vector<int> &variables);
+	void update_red_connected_variables(const vector<int> &variables);
+
+	// Number of calls to compute_semi_relaxed_plan (excluding trivial ones where the goal already holds) and their total time
+	int num_semi_relaxed_plans;
+	double semi_relaxed_plan_time;
+
+	// Bounded cache of semi-relaxed plans, keyed by the state, the goal facts, the base relaxed plan, the legal operators and the painting
+	using SemiRelaxedPlanCacheKey = std::pair<std::vector<int>, std::vector<boost::dynamic_bitset<>::block_type>>;
+	using SemiRelaxedPlan = std::pair<bool, std::vector<OperatorID>>;
+	int semi_relaxed_plan_cache_size;
+	utils::HashMap<SemiRelaxedPlanCacheKey, SemiRelaxedPlan> semi_relaxed_plan_cache;
+	int num_semi_relaxed_plan_cache_lookups;
+	int num_semi_relaxed_plan_cache_hits;
+	auto get_semi_relaxed_plan_cache_key(std::vector<int> state_key, const std::vector<FactPair> &goal_facts, const std::vector<OperatorID> &base_relaxed_plan, const boost::dynamic_bitset<> &legal_operators) const -> SemiRelaxedPlanCacheKey;
+	auto lookup_semi_relaxed_plan(const SemiRelaxedPlanCacheKey &key) -> const SemiRelaxedPlan *;
+	void store_semi_relaxed_plan(SemiRelaxedPlanCacheKey &&key, const SemiRelaxedPlan &plan);
+	auto compute_semi_relaxed_plan_uncached(const std::vector<int> &state_values, const std::vector<FactPair> &goal_facts, const std::vector<OperatorID> &base_relaxed_plan, const boost::dynamic_bitset<> &legal_operators) -> SemiRelaxedPlan;
+	auto compute_semi_relaxed_plan_uncached(const std::vector<FactPair> &available_facts, const std::vector<bool> &outside_red_variables, const std::vector<FactPair> &goal_facts, const std::vector<OperatorID> &base_relaxed_plan, const boost::dynamic_bitset<> &legal_operators) -> SemiRelaxedPlan;
 
 	void mark_red_sufficient(int op_no);
 
@@ -275,6 +301,11 @@ public:
 	auto compute_semi_relaxed_plan(const std::vector<int> &state_values, const std::vector<FactPair> &goal_facts, const std::vector<OperatorID> &base_relaxed_plan, const boost::dynamic_bitset<> &legal_operators) -> std::pair<bool, std::vector<OperatorID>>;
 	auto compute_semi_relaxed_plan(const std::vector<FactPair> &available_facts, const std::vector<bool> &outside_red_variables, const std::vector<FactPair> &goal_facts, const std::vector<OperatorID> &base_relaxed_plan, const boost::dynamic_bitset<> &legal_operators) -> std::pair<bool, std::vector<OperatorID>>;
 
+	auto get_num_semi_relaxed_plans() const -> int { return num_semi_relaxed_plans; }
+	auto get_semi_relaxed_plan_time() const -> double { return semi_relaxed_plan_time; }
+	auto get_num_semi_relaxed_plan_cache_lookups() const -> int { return num_semi_relaxed_plan_cache_lookups; }
+	auto get_num_semi_relaxed_plan_cache_hits() const -> int { return num_semi_relaxed_plan_cache_hits; }
+
 	auto is_black(int var) const -> bool { return black_vars[var]; }
 	auto is_red(int var) const -> bool { return !black_vars[var]; }
 
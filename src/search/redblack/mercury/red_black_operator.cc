@@ -52,21 +52,39 @@ void RedBlackOperator::set_black_pre_eff(const vector<bool>& black_vars) {
 
 }
 
-bool RedBlackOperator::is_red_applicable(const std::vector<std::vector<int>> &values) const {
+static void move_variable_assignment(int var, partial_assignment &from, partial_assignment &to) {
+	auto it = from.lower_bound(make_pair(var, 0));
+	if (it == from.end() || it->first != var)
+		return;
+	to.insert(*it);
+	from.erase(it);
+}
+
+void RedBlackOperator::set_variable_color(int var, bool black) {
+	if (black) {
+		move_variable_assignment(var, red_precondition, black_precondition);
+		move_variable_assignment(var, red_effect, black_effect);
+	} else {
+		move_variable_assignment(var, black_precondition, red_precondition);
+		move_variable_assignment(var, black_effect, red_effect);
+	}
+}
+
+bool RedBlackOperator::is_red_applicable(const SemiRelaxedState &values) const {
 	for (partial_assignment::iterator it=red_precondition.begin(); it != red_precondition.end(); ++it) {
-		if (!std::binary_search(std::begin(values[it->first]), std::end(values[it->first]), it->second))
+		if (!values.contains(it->first, it->second))
 			return false;
 	}
 	return true;
 }
 
-bool RedBlackOperator::is_applicable(const std::vector<std::vector<int>> &values) const {
+bool RedBlackOperator::is_applicable(const SemiRelaxedState &values) const {
 	for (partial_assignment::iterator it = red_precondition.begin(); it != red_precondition.end(); ++it) {
-		if (!std::binary_search(std::begin(values[it->first]), std::end(values[it->first]), it->second))
+		if (!values.contains(it->first, it->second))
 			return false;
 	}
 	for (partial_assignment::iterator it = black_precondition.begin(); it != black_precondition.end(); ++it) {
-		if (!std::binary_search(std::begin(values[it->first]), std::end(values[it->first]), it->second))
+		if (!values.contains(it->first, it->second))
 			return false;
 	}
 	return true;
@@ -84,19 +102,16 @@ bool RedBlackOperator::is_applicable(const GlobalState& state) const {
 	return true;
 }
 
-void RedBlackOperator::apply(std::vector<std::vector<int>> &values, const std::vector<bool> *outside_red_variables) const {
+void RedBlackOperator::apply(SemiRelaxedState &values, const std::vector<bool> *outside_red_variables) const {
 	for (partial_assignment::iterator it=red_effect.begin(); it != red_effect.end(); ++it) {
 		if (!outside_red_variables || !outside_red_variables->at(it->first)) {
-			values[it->first] = {it->second};
+			values.set(it->first, it->second);
 		} else {
-			if (!std::binary_search(std::begin(values[it->first]), std::end(values[it->first]), it->second)) {
-				values[it->first].push_back(it->second);
-				std::inplace_merge(std::begin(values[it->first]), std::end(values[it->first]) - 1, std::end(values[it->first]));
-			}
+			values.add(it->first, it->second);
 		}
 	}
 	for (partial_assignment::iterator it=black_effect.begin(); it != black_effect.end(); ++it) {
-		values[it->first] = {it->second};
+		values.set(it->first, it->second);
 	}
 }
 
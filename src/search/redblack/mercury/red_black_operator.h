@@ -6,6 +6,7 @@
 #include <set>
 
 #include "../operator.h"
+#include "semi_relaxed_state.h"
 
 #include <cassert>
 
@@ -23,16 +24,18 @@ public:
 	void reset();
 
 	void set_black_pre_eff(const std::vector<bool>& black_vars);
+	// Moves the precondition and effect on var (if any) to the black or red part
+	void set_variable_color(int var, bool black);
 	const partial_assignment& get_red_precondition() const { return red_precondition;}
 	const partial_assignment& get_black_precondition() const { return black_precondition;}
 	const partial_assignment& get_red_effect() const { return red_effect;}
 	const partial_assignment& get_black_effect() const { return black_effect;}
 
 
-	bool is_red_applicable(const std::vector<std::vector<int>> &values) const;
-	bool is_applicable(const std::vector<std::vector<int>> &values) const;
+	bool is_red_applicable(const SemiRelaxedState &values) const;
+	bool is_applicable(const SemiRelaxedState &values) const;
 	bool is_applicable(const GlobalState& state) const;
-	void apply(std::vector<std::vector<int>> &values, const std::vector<bool> *outside_red_variables) const;
+	void apply(SemiRelaxedState &values, const std::vector<bool> *outside_red_variables) const;
 	void dump() const;
 	int get_op_no() const { return op_no; }
 };
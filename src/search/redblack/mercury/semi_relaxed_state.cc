@@ -0,0 +1,78 @@
+#include "semi_relaxed_state.h"
+
+#include <algorithm>
+#include <cassert>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// index of the lowest set bit of a non-zero word
+static auto get_lowest_set_bit(std::uint64_t word) -> int {
+	assert(word);
+#ifdef _MSC_VER
+	unsigned long bit;
+	_BitScanForward64(&bit, word);
+	return static_cast<int>(bit);
+#else
+	return __builtin_ctzll(word);
+#endif
+}
+
+
+SemiRelaxedState::SemiRelaxedState()
+	: use_bitsets(false) {}
+
+SemiRelaxedState::SemiRelaxedState(const std::vector<int> &domain_sizes, bool use_bitsets)
+	: use_bitsets(use_bitsets) {
+	if (use_bitsets) {
+		word_offsets.reserve(domain_sizes.size() + 1);
+		word_offsets.push_back(0);
+		for (auto domain_size : domain_sizes)
+			word_offsets.push_back(word_offsets.back() + (domain_size + BITS_PER_WORD - 1) / BITS_PER_WORD);
+		words.resize(word_offsets.back(), 0);
+	} else {
+		value_lists.resize(domain_sizes.size());
+	}
+}
+
+void SemiRelaxedState::clear() {
+	if (use_bitsets) {
+		std::fill(std::begin(words), std::end(words), 0);
+	} else {
+		for (auto &values : value_lists)
+			values.clear();
+	}
+}
+
+void SemiRelaxedState::add(int var, int value) {
+	if (use_bitsets) {
+		words[word_offsets[var] + value / BITS_PER_WORD] |= get_bit(value);
+		return;
+	}
+	auto &values = value_lists[var];
+	if (!std::binary_search(std::begin(values), std::end(values), value)) {
+		values.push_back(value);
+		std::inplace_merge(std::begin(values), std::end(values) - 1, std::end(values));
+	}
+}
+
+auto SemiRelaxedState::count(int var) const -> int {
+	if (!use_bitsets)
+		return value_lists[var].size();
+	auto num_values = 0;
+	for (auto i = word_offsets[var]; i < word_offsets[var + 1]; ++i)
+		for (auto word = words[i]; word; word &= word - 1)
+			++num_values;
+	return num_values;
+}
+
+auto SemiRelaxedState::get_values(int var) const -> const std::vector<int> & {
+	if (!use_bitsets)
+		return value_lists[var];
+	values_buffer.clear();
+	for (auto i = word_offsets[var]; i < word_offsets[var + 1]; ++i)
+		for (auto word = words[i]; word; word &= word - 1)
+			values_buffer.push_back((i - word_offsets[var]) * BITS_PER_WORD + get_lowest_set_bit(word));
+	return values_buffer;
+}
@@ -0,0 +1,59 @@
+#ifndef RED_BLACK_SEMI_RELAXED_STATE_H
+#define RED_BLACK_SEMI_RELAXED_STATE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+
+// The values of all variables in a semi-relaxed state.
+// They are stored either as sorted value lists, or as fixed-size bitsets in a single contiguous word array.
+class SemiRelaxedState {
+	using Word = std::uint64_t;
+	static constexpr int BITS_PER_WORD = 64;
+
+	bool use_bitsets;
+
+	// sorted value lists
+	std::vector<std::vector<int>> value_lists;
+
+	// bitsets, the words of variable var are in [word_offsets[var], word_offsets[var + 1])
+	std::vector<int> word_offsets;
+	std::vector<Word> words;
+	mutable std::vector<int> values_buffer;
+
+	static auto get_bit(int value) -> Word { return Word(1) << (value % BITS_PER_WORD); }
+
+public:
+	SemiRelaxedState();
+	SemiRelaxedState(const std::vector<int> &domain_sizes, bool use_bitsets);
+
+	void clear();
+
+	auto contains(int var, int value) const -> bool {
+		if (use_bitsets)
+			return words[word_offsets[var] + value / BITS_PER_WORD] & get_bit(value);
+		const auto &values = value_lists[var];
+		assert(std::is_sorted(std::begin(values), std::end(values)));
+		return std::binary_search(std::begin(values), std::end(values), value);
+	}
+
+	// replace the values of var by the given value
+	void set(int var, int value) {
+		if (use_bitsets) {
+			std::fill(std::begin(words) + word_offsets[var], std::begin(words) + word_offsets[var + 1], 0);
+			words[word_offsets[var] + value / BITS_PER_WORD] |= get_bit(value);
+		} else {
+			value_lists[var] = {value};
+		}
+	}
+
+	// add the given value to the values of var
+	void add(int var, int value);
+
+	auto count(int var) const -> int;
+	auto get_values(int var) const -> const std::vector<int> &;
+};
+
+#endif
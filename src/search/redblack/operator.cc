@@ -1,5 +1,7 @@
 #include "operator.h"
 
+#include <algorithm>
+
 namespace redblack {
 
 auto RBOperator::is_applicable(const RBState &state) const -> bool {
@@ -8,30 +10,28 @@ auto RBOperator::is_applicable(const RBState &state) const -> bool {
 	});
 }
 
-RBOperator::RBOperator(const GlobalOperator &base_operator)
-	: base_operator(base_operator),
-	  black_preconditions(),
-	  red_preconditions(),
-	  black_effects(),
-	  red_effects() {}
-
-void RBOperator::apply_painting(const Painting &painting) {
-	black_preconditions.clear();
-	red_preconditions.clear();
-	black_effects.clear();
-	red_effects.clear();
-	for (const auto &precondition : base_operator.get_preconditions()) {
-		if (painting.is_black_var(precondition.var))
-			black_preconditions.push_back(&precondition);
-		else
-			red_preconditions.push_back(&precondition);
-	}
-	for (const auto &effect : base_operator.get_effects()) {
-		if (painting.is_black_var(effect.var))
-			black_effects.push_back(&effect);
-		else
-			red_effects.push_back(&effect);
-	}
+template<class Element>
+auto RBOperator::get_black_mask(TableSpan<const Element *> elements, const Painting &painting) -> std::uint64_t {
+	auto mask = std::uint64_t(0);
+	if (elements.size() <= PaintedView<Element>::MAX_MASKED_ENTRIES)
+		for (auto i = 0u; i < elements.size(); ++i)
+			if (painting.is_black_var(elements.begin()[i]->var))
+				mask |= std::uint64_t(1) << i;
+	return mask;
 }
 
+RBOperator::RBOperator(const GlobalOperator &base_operator, const Painting &painting)
+	: base_operator(base_operator),
+	  painting(&painting),
+	  preconditions(SharedTaskData::get().get_preconditions(get_op_index_hacked(&base_operator))),
+	  effects(SharedTaskData::get().get_effects(get_op_index_hacked(&base_operator))),
+	  black_preconditions_mask(get_black_mask(preconditions, painting)),
+	  black_effects_mask(get_black_mask(effects, painting)),
+	  num_black_preconditions(std::count_if(std::begin(preconditions), std::end(preconditions), [&painting](const auto precondition) {
+		  return painting.is_black_var(precondition->var);
+	  })),
+	  num_black_effects(std::count_if(std::begin(effects), std::end(effects), [&painting](const auto effect) {
+		  return painting.is_black_var(effect->var);
+	  })) {}
+
 }
@@ -1,28 +1,126 @@
 #ifndef REDBLACK_OPERATOR_H
 #define REDBLACK_OPERATOR_H
 
+#include "shared_task_data.h"
 #include "state.h"
 #include "../global_operator.h"
 #include "../operator_id.h"
 
+#include <cstdint>
+#include <iterator>
+
 namespace redblack {
 
+// the entries of a shared operator table whose variables have the given color in a painting
+// the entries of the color are given by a bit mask of their positions, tables with more than
+// MAX_MASKED_ENTRIES entries look up the color of each entry in the painting instead
+template<class Element>
+class PaintedView {
+	TableSpan<const Element *> elements;
+	std::uint64_t mask;
+	const Painting *painting;
+	bool black;
+	int count;
+
+public:
+	static constexpr std::size_t MAX_MASKED_ENTRIES = 64;
+
+	class Iterator {
+		const Element *const *first;
+		const Element *const *position;
+		const Element *const *last;
+		std::uint64_t mask;
+		const Painting *painting;
+		bool black;
+
+		auto has_color() const -> bool {
+			return painting ? painting->is_black_var((*position)->var) == black : (mask >> (position - first)) & 1;
+		}
+
+		void skip_other_color() {
+			while (position != last && !has_color())
+				++position;
+		}
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = const Element *;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const Element *const *;
+		using reference = const Element *const &;
+
+		Iterator(const Element *const *first, const Element *const *position, const Element *const *last, std::uint64_t mask, const Painting *painting, bool black)
+			: first(first),
+			  position(position),
+			  last(last),
+			  mask(mask),
+			  painting(painting),
+			  black(black) {
+			skip_other_color();
+		}
+
+		auto operator*() const -> reference { return *position; }
+
+		auto operator++() -> Iterator & {
+			++position;
+			skip_other_color();
+			return *this;
+		}
+
+		auto operator++(int) -> Iterator {
+			auto result = *this;
+			++*this;
+			return result;
+		}
+
+		auto operator==(const Iterator &other) const -> bool { return position == other.position; }
+		auto operator!=(const Iterator &other) const -> bool { return position != other.position; }
+	};
+
+	// black_mask is ignored (and the painting is used) if there are more than MAX_MASKED_ENTRIES elements
+	PaintedView(TableSpan<const Element *> elements, std::uint64_t black_mask, const Painting &painting, bool black, int count)
+		: elements(elements),
+		  mask(black ? black_mask : ~black_mask),
+		  painting(elements.size() > MAX_MASKED_ENTRIES ? &painting : nullptr),
+		  black(black),
+		  count(count) {}
+
+	auto begin() const -> Iterator { return Iterator(elements.begin(), elements.begin(), elements.end(), mask, painting, black); }
+	auto end() const -> Iterator { return Iterator(elements.begin(), elements.end(), elements.end(), mask, painting, black); }
+	auto size() const -> std::size_t { return count; }
+	auto empty() const -> bool { return count == 0; }
+};
+
+/*
+  Red-black view of an operator. It does not copy the preconditions and
+  effects, but splits the shared tables of SharedTaskData by the painting.
+*/
 class RBOperator {
 	const GlobalOperator &base_operator;
+	const Painting *painting;
+
+	TableSpan<const GlobalCondition *> preconditions;
+	TableSpan<const GlobalEffect *> effects;
+	// positions of the black entries in the tables (see PaintedView)
+	std::uint64_t black_preconditions_mask;
+	std::uint64_t black_effects_mask;
+	int num_black_preconditions;
+	int num_black_effects;
 
-	std::vector<const GlobalCondition *> black_preconditions;
-	std::vector<const GlobalCondition *> red_preconditions;
-	std::vector<const GlobalEffect *> black_effects;
-	std::vector<const GlobalEffect *> red_effects;
+	template<class Element>
+	static auto get_black_mask(TableSpan<const Element *> elements, const Painting &painting) -> std::uint64_t;
 
 public:
-	explicit RBOperator(const GlobalOperator &base_operator);
+	RBOperator(const GlobalOperator &base_operator, const Painting &painting);
 
-	void apply_painting(const Painting &painting);
 	auto is_applicable(const RBState &state) const -> bool;
 
 	auto is_black() const -> bool {
-		return !black_effects.empty();
+		return num_black_effects != 0;
+	}
+
+	auto get_painting() const -> const Painting & {
+		return *painting;
 	}
 
 	auto get_base_operator() const -> const GlobalOperator & {
@@ -37,20 +135,20 @@ public:
 		return OperatorID(get_op_index_hacked(&base_operator));
 	}
 
-	auto get_black_preconditions() const -> const std::vector<const GlobalCondition *> & {
-		return black_preconditions;
+	auto get_black_preconditions() const -> PaintedView<GlobalCondition> {
+		return {preconditions, black_preconditions_mask, *painting, true, num_black_preconditions};
 	}
 
-	auto get_red_preconditions() const -> const std::vector<const GlobalCondition *> & {
-		return red_preconditions;
+	auto get_red_preconditions() const -> PaintedView<GlobalCondition> {
+		return {preconditions, black_preconditions_mask, *painting, false, static_cast<int>(preconditions.size()) - num_black_preconditions};
 	}
 
-	auto get_black_effects() const -> const std::vector<const GlobalEffect *> & {
-		return black_effects;
+	auto get_black_effects() const -> PaintedView<GlobalEffect> {
+		return {effects, black_effects_mask, *painting, true, num_black_effects};
 	}
 
-	auto get_red_effects() const -> const std::vector<const GlobalEffect *> & {
-		return red_effects;
+	auto get_red_effects() const -> PaintedView<GlobalEffect> {
+		return {effects, black_effects_mask, *painting, false, static_cast<int>(effects.size()) - num_black_effects};
 	}
 
 };
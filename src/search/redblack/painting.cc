@@ -1,6 +1,7 @@
 #include "painting.h" 
 
 #include "painting_utils.h"
+#include "shared_task_data.h"
 #include "util.h"
 #include "../globals.h"
 #include "../options/options.h"
@@ -25,6 +26,19 @@ auto operator<<(std::ostream &out, const Painting &painting) -> std::ostream & {
 	return out;
 }
 
+void PaintingRegistry::pack(const InternalPaintingType &painting) {
+	packed_painting.assign((painting.size() + 63) / 64, 0);
+	for (auto var = 0u; var < painting.size(); ++var)
+		if (painting[var])
+			packed_painting[var / 64] |= std::uint64_t(1) << (var % 64);
+}
+
+auto PaintingRegistry::insert(const InternalPaintingType &painting) -> std::pair<int, bool> {
+	pack(painting);
+	auto [it, inserted] = painting_ids.emplace(packed_painting, painting_ids.size());
+	return {it->second, inserted};
+}
+
 PaintingFactory::PaintingFactory(const options::Options &opts)
 	: force_cg_leaves_red(opts.get<bool>("force_cg_leaves_red")) {}
 
@@ -71,6 +85,7 @@ auto CGTopFirstPaintingFactory::construct_painting() -> InternalPaintingType {
 CGBranchFirstPaintingFactory::CGBranchFirstPaintingFactory(const options::Options &opts)
 	: PaintingFactory(opts),
 	  num_black_vars(get_num_black(opts)),
+	  num_candidates(opts.get<int>("num_candidates")),
 	  scc_painted(),
 	  scc_offset_to_level() {}
 
@@ -141,8 +156,8 @@ auto CGBranchFirstPaintingFactory::get_connected_components(std::vector<int> var
 	return components;
 }
 
-auto CGBranchFirstPaintingFactory::paint_dfs_sccs(int cur_scc_offset, int starting_var_of_scc, std::vector<std::set<int>> sccs, InternalPaintingType &painting, int &already_black) -> bool {
-	std::set<int> cur_scc = sccs[cur_scc_offset];
+auto CGBranchFirstPaintingFactory::paint_dfs_sccs(int cur_scc_offset, int starting_var_of_scc, const std::vector<std::set<int>> &sccs, const std::vector<int> &var_to_scc_offset, InternalPaintingType &painting, int &already_black) -> bool {
+	const std::set<int> &cur_scc = sccs[cur_scc_offset];
 	//paint the current scc
 	if (paint_succ_rec(starting_var_of_scc, painting, already_black, cur_scc)) {
 		cout << "painting scc limit reached" << endl;
@@ -168,18 +183,16 @@ auto CGBranchFirstPaintingFactory::paint_dfs_sccs(int cur_scc_offset, int starti
 	std::set<int> offsets_for_scc_succs_of_cur_scc;
 	std::vector<int> map_scc_to_starting_var(sccs.size(), -1);
 	for (std::size_t i = 0; i < succ_outside_scc.size(); i++) {
-		for (std::size_t j = 0; j < sccs.size(); j++) {
-			if (sccs[j].find(succ_outside_scc[i]) != sccs[j].end()) {
-				//the scc containing [i] is [j]
-				offsets_for_scc_succs_of_cur_scc.insert(j);
-
-				if (scc_offset_to_level[j] == -1)
-					scc_offset_to_level[j] = scc_offset_to_level[cur_scc_offset] + 1;
+		int j = var_to_scc_offset[succ_outside_scc[i]];
+		if (j != -1) {
+			//the scc containing [i] is [j]
+			offsets_for_scc_succs_of_cur_scc.insert(j);
 
-				if (map_scc_to_starting_var[j] == -1)
-					map_scc_to_starting_var[j] = succ_outside_scc[i];
+			if (scc_offset_to_level[j] == -1)
+				scc_offset_to_level[j] = scc_offset_to_level[cur_scc_offset] + 1;
 
-			}
+			if (map_scc_to_starting_var[j] == -1)
+				map_scc_to_starting_var[j] = succ_outside_scc[i];
 		}
 	}
 	//cout << "successors of current scc: "<< offsets_for_scc_succs_of_cur_scc.size() << endl;
@@ -196,7 +209,7 @@ auto CGBranchFirstPaintingFactory::paint_dfs_sccs(int cur_scc_offset, int starti
 	for (std::size_t i = 0; i < offsets_for_scc_succs_as_array.size(); i++) {
 		int scc_offset = offsets_for_scc_succs_as_array[i];
 		if (!scc_painted[scc_offset]) {
-			if (paint_dfs_sccs(scc_offset, map_scc_to_starting_var[scc_offset], sccs, painting, already_black)) {
+			if (paint_dfs_sccs(scc_offset, map_scc_to_starting_var[scc_offset], sccs, var_to_scc_offset, painting, already_black)) {
 				limit_reached = true;
 				break;
 			}
@@ -206,7 +219,7 @@ auto CGBranchFirstPaintingFactory::paint_dfs_sccs(int cur_scc_offset, int starti
 	return limit_reached;
 }
 
-auto CGBranchFirstPaintingFactory::paint_succ_rec(int cur_node, InternalPaintingType &painting, int &already_black, std::set<int> &scc) -> bool {
+auto CGBranchFirstPaintingFactory::paint_succ_rec(int cur_node, InternalPaintingType &painting, int &already_black, const std::set<int> &scc) -> bool {
 	//cout << "remaining_black: " << already_black << endl;
 	if (already_black >= num_black_vars)
 		return true;
@@ -234,6 +247,21 @@ auto CGBranchFirstPaintingFactory::paint_succ_rec(int cur_node, InternalPainting
 }
 
 auto CGBranchFirstPaintingFactory::construct_painting() -> InternalPaintingType {
+	if (num_candidates == 1)
+		return construct_candidate_painting(0);
+	auto candidates = std::vector<InternalPaintingType>();
+	// paint_succ_rec increases the number of black variables for each CG leaf that is kept red
+	const auto initial_num_black_vars = num_black_vars;
+	for (auto i = 0; i < num_candidates; ++i) {
+		num_black_vars = initial_num_black_vars;
+		candidates.push_back(construct_candidate_painting(i));
+	}
+	const auto best_candidate = get_least_conflicts_candidate(candidates, g_initial_state_data, get_goal_facts());
+	std::cout << "Using candidate painting " << best_candidate << " of " << num_candidates << std::endl;
+	return candidates[best_candidate];
+}
+
+auto CGBranchFirstPaintingFactory::construct_candidate_painting(int source_rotation) -> InternalPaintingType {
 	auto painting = get_all_red_painting();
 	std::vector<int> all_vars(g_variable_domain.size());
 	for (std::size_t i = 0; i < g_variable_domain.size(); ++i) {
@@ -248,13 +276,20 @@ auto CGBranchFirstPaintingFactory::construct_painting() -> InternalPaintingType
 	for (std::size_t i = 0; i < ccs.size(); i++) {
 		//paint one connected component at a time
 
-		//find the strongly connected components
+		//find the strongly connected components, the ones of the whole causal graph are shared
 		std::vector<int> component(ccs[i].begin(), ccs[i].end());
-		std::vector<std::set<int>> sccs = rbutils::get_sccs(component);
+		std::vector<std::set<int>> component_sccs;
+		if (component.size() != g_variable_domain.size())
+			component_sccs = rbutils::get_sccs(component);
+		const auto &sccs = component.size() == g_variable_domain.size() ? CausalGraphSCCs::get().get_sccs() : component_sccs;
 
 		//init arrays
 		scc_painted = std::vector<bool>(sccs.size(), false);
 		scc_offset_to_level = std::vector<int>(sccs.size(), -1);
+		std::vector<int> var_to_scc_offset(g_variable_domain.size(), -1);
+		for (std::size_t j = 0; j < sccs.size(); j++)
+			for (int var : sccs[j])
+				var_to_scc_offset[var] = j;
 
 		std::cout << "strongly cc size: " << sccs.size() << std::endl;
 
@@ -286,11 +321,13 @@ auto CGBranchFirstPaintingFactory::construct_painting() -> InternalPaintingType
 		}
 
 		std::cout << "sources size: " << source_sccs_offsets.size() << std::endl;
+		if (!source_sccs_offsets.empty())
+			std::rotate(std::begin(source_sccs_offsets), std::begin(source_sccs_offsets) + source_rotation % source_sccs_offsets.size(), std::end(source_sccs_offsets));
 
 		int already_black = 0;
 		//paint the strongly connected components black starting from sources
 		for (std::size_t j = 0; j < source_sccs_offsets.size(); j++) {
-			if (paint_dfs_sccs(source_sccs_offsets[j], *sccs[source_sccs_offsets[j]].begin(), sccs, painting, already_black)) {
+			if (paint_dfs_sccs(source_sccs_offsets[j], *sccs[source_sccs_offsets[j]].begin(), sccs, var_to_scc_offset, painting, already_black)) {
 				limit_reached = true;
 				break;
 			}
@@ -310,6 +347,7 @@ IncSCCLvlPaintingFactory::IncSCCLvlPaintingFactory(const options::Options &opts)
 	: PaintingFactory(opts),
 	  num_black_vars(get_num_black(opts)),
 	  random_within_scc(opts.get<bool>("scc_random")),
+	  num_candidates(opts.get<int>("num_candidates")),
 	  rng(utils::parse_rng_from_options(opts)) {}
 
 void IncSCCLvlPaintingFactory::randomly_paint_scc(InternalPaintingType &painting, const std::vector<int> &scc, std::size_t number_black) {
@@ -338,7 +376,7 @@ void IncSCCLvlPaintingFactory::randomly_paint_scc(InternalPaintingType &painting
 auto IncSCCLvlPaintingFactory::construct_painting() -> InternalPaintingType {
     // special case if all vars shall be black
     if (num_black_vars == g_root_task()->get_num_variables())
-		return force_cg_leaves_red && rbutils::get_sccs({}).size() > 1 ?
+		return force_cg_leaves_red && CausalGraphSCCs::get().get_sccs().size() > 1 ?
 			get_cg_leaves_painting() :
 			get_all_black_painting();
 
@@ -347,13 +385,20 @@ auto IncSCCLvlPaintingFactory::construct_painting() -> InternalPaintingType {
 		return get_all_red_painting();
 
 	// special case if CG is strongly connected
-	auto sccs = rbutils::get_sccs({});
+	const auto &sccs = CausalGraphSCCs::get().get_sccs();
 	if (sccs.size() == 1) {
 		std::cout << "CG is strongly connected" << std::endl;
 		auto painting = get_all_red_painting();
 
 		if (random_within_scc) {
-			randomly_paint_scc(painting, std::vector<int>(sccs[0].begin(), sccs[0].end()), num_black_vars);
+			const auto scc = std::vector<int>(sccs[0].begin(), sccs[0].end());
+			auto candidates = std::vector<InternalPaintingType>(num_candidates, painting);
+			for (auto &candidate : candidates)
+				randomly_paint_scc(candidate, scc, num_black_vars);
+			const auto best_candidate = get_least_conflicts_candidate(candidates, g_initial_state_data, get_goal_facts());
+			if (num_candidates > 1)
+				std::cout << "Using candidate painting " << best_candidate << " of " << num_candidates << std::endl;
+			painting = std::move(candidates[best_candidate]);
 		} else {
 			for (int i = 0; i < num_black_vars; ++i)
 				painting[i] = false;
@@ -372,7 +417,7 @@ auto IncSCCLvlPaintingFactory::construct_painting() -> InternalPaintingType {
 	//             return is_red_var;
 	//         }    
 
-	auto sccs_per_level = rbutils::get_scc_levels(sccs);
+	const auto &sccs_per_level = CausalGraphSCCs::get().get_sccs_per_level();
 
 	if (num_black_vars == 1) {
 		for (std::size_t lvl = 0; lvl < sccs_per_level.size(); ++lvl) {
@@ -475,6 +520,12 @@ void PaintingFactory::add_options_to_parser(options::OptionParser &parser) {
 	add_num_black_options(parser);
 }
 
+static void add_num_candidates_option(options::OptionParser &parser, const std::string &candidates_doc) {
+	parser.add_option<int>("num_candidates", "number of candidate paintings (" + candidates_doc + "). If there is more than one candidate, the one "
+		"whose red variables have the fewest conflicts in the relaxed plan from the initial state is used. The candidates are evaluated one after another.",
+		"1", options::Bounds("1", "infinity"));
+}
+
 static auto _parse_cg_top_first(options::OptionParser &parser) -> std::shared_ptr<Painting> {
     // TODO docu
 	PaintingFactory::add_options_to_parser(parser);
@@ -486,6 +537,7 @@ static auto _parse_cg_top_first(options::OptionParser &parser) -> std::shared_pt
 
 static auto _parse_cg_branches_first(options::OptionParser &parser) -> std::shared_ptr<Painting> {
 	PaintingFactory::add_options_to_parser(parser);
+	add_num_candidates_option(parser, "candidate i starts the painting of each connected component of the causal graph at its i-th source SCC");
 
 	if (parser.help_mode() || parser.dry_run())
 		return nullptr;
@@ -495,6 +547,7 @@ static auto _parse_cg_branches_first(options::OptionParser &parser) -> std::shar
 static auto _parse_inc_scc_lvl(options::OptionParser &parser) -> std::shared_ptr<Painting> {
 	PaintingFactory::add_options_to_parser(parser);
     parser.add_option<bool>("scc_random", "TODO", "false");
+	add_num_candidates_option(parser, "only if the causal graph is strongly connected and scc_random is set, each candidate is painted randomly");
 
 	if (parser.help_mode() || parser.dry_run())
 		return nullptr;
@@ -1,8 +1,10 @@
 #ifndef REDBLACK_PAINTING_H
 #define REDBLACK_PAINTING_H
 
+#include "../utils/hash.h"
 #include "../utils/rng.h"
 
+#include <cstdint>
 #include <set>
 #include <vector>
 #include <memory>
@@ -51,6 +53,26 @@ public:
 };
 
 
+// Hands out dense ids for paintings, in the order in which the paintings are registered.
+// The paintings are stored and hashed as packed 64-bit words.
+class PaintingRegistry {
+	using PackedPainting = std::vector<std::uint64_t>;
+
+	utils::HashMap<PackedPainting, int> painting_ids;
+	PackedPainting packed_painting;
+
+	void pack(const InternalPaintingType &painting);
+
+public:
+	PaintingRegistry() = default;
+
+	// returns the id of the painting and whether it was registered by this call
+	auto insert(const InternalPaintingType &painting) -> std::pair<int, bool>;
+
+	auto size() const -> int { return painting_ids.size(); }
+};
+
+
 
 class PaintingFactory {
 public:
@@ -83,12 +105,15 @@ public:
 
 class CGBranchFirstPaintingFactory : public PaintingFactory {
 	int num_black_vars;
+	// number of candidate paintings, candidate i starts the painting of each connected component at its i-th source SCC
+	const int num_candidates;
 	std::vector<bool> scc_painted;
 	std::vector<int> scc_offset_to_level;
 
 	static auto get_connected_components(std::vector<int> variables) -> std::vector<std::set<int>>;
-	auto paint_dfs_sccs(int cur_scc_offset, int starting_var_of_scc, std::vector<std::set<int>> sccs, InternalPaintingType &painting, int &already_black) -> bool;
-	auto paint_succ_rec(int cur_node, InternalPaintingType &painting, int &already_black, std::set<int> &scc) -> bool;
+	auto paint_dfs_sccs(int cur_scc_offset, int starting_var_of_scc, const std::vector<std::set<int>> &sccs, const std::vector<int> &var_to_scc_offset, InternalPaintingType &painting, int &already_black) -> bool;
+	auto paint_succ_rec(int cur_node, InternalPaintingType &painting, int &already_black, const std::set<int> &scc) -> bool;
+	auto construct_candidate_painting(int source_rotation) -> InternalPaintingType;
 
 public:
 	CGBranchFirstPaintingFactory(const options::Options &opts);
@@ -100,6 +125,8 @@ public:
 class IncSCCLvlPaintingFactory : public PaintingFactory {
 	const int num_black_vars;
 	const bool random_within_scc;
+	// number of random candidate paintings if the causal graph is strongly connected and random_within_scc is set
+	const int num_candidates;
 	const std::shared_ptr<utils::RandomNumberGenerator> rng;
 
 	void randomly_paint_scc(InternalPaintingType &painting, const std::vector<int> &scc, std::size_t number_black);
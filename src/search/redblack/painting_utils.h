@@ -5,6 +5,7 @@
 #include "../algorithms/sccs.h"
 #include "../globals.h"
 
+#include <algorithm>
 #include <set>
 
 namespace redblack {
@@ -14,14 +15,16 @@ inline auto get_sccs(std::vector<int> variables) -> std::vector<std::set<int>> {
 	std::vector<std::vector<int>> vars(g_root_task()->get_num_variables());
 	std::size_t bound = variables.empty() ? g_root_task()->get_num_variables() : variables.size();
 	const auto &causal_graph = causal_graph::get_causal_graph(g_root_task().get());
+	std::vector<bool> is_contained(g_root_task()->get_num_variables(), variables.empty());
+	for (const auto var : variables)
+		is_contained[var] = true;
 	for (std::size_t i = 0; i < bound; i++) {
 		if (variables.empty() || variables.size() == g_variable_domain.size()) {
 			vars[i] = causal_graph.get_successors(i);
 		} else {
-			std::vector<int> successors = causal_graph.get_successors(variables[i]);
-			for (std::size_t succ = 0; succ < successors.size(); succ++) {
-				if (std::find(variables.begin(), variables.end(), successors[succ]) != variables.end()) {
-					vars[variables[i]].push_back(successors[succ]);
+			for (const auto successor : causal_graph.get_successors(variables[i])) {
+				if (is_contained[successor]) {
+					vars[variables[i]].push_back(successor);
 				}
 			}
 		}
@@ -35,7 +38,7 @@ inline auto get_sccs(std::vector<int> variables) -> std::vector<std::set<int>> {
 	for (std::size_t i = 0; i < found_sccs.size(); i++) {
 		if (found_sccs[i].size() != 1 || variables.empty() || variables.size() == g_variable_name.size()) {
 			real_sccs.push_back(std::set<int>(found_sccs[i].begin(), found_sccs[i].end()));
-		} else if (std::find(variables.begin(), variables.end(), found_sccs[i][0]) != variables.end()) {
+		} else if (is_contained[found_sccs[i][0]]) {
 			// this can happen if not all variables are in *variables*
 			// the SCC class needs the input vector to be aligned very specifically
 			real_sccs.push_back(std::set<int>(found_sccs[i].begin(), found_sccs[i].end()));
@@ -49,7 +52,7 @@ inline auto get_sccs(std::vector<int> variables) -> std::vector<std::set<int>> {
 	return real_sccs;
 }
 
-inline auto get_scc_levels(std::vector<std::set<int>> sccs) -> std::vector<std::vector<std::set<int>>> {
+inline auto get_scc_levels(const std::vector<std::set<int>> &sccs) -> std::vector<std::vector<std::set<int>>> {
 	// determine topology
 	std::vector<std::vector<std::set<int>>> sccs_per_level(1);
 
@@ -64,7 +67,7 @@ inline auto get_scc_levels(std::vector<std::set<int>> sccs) -> std::vector<std::
 		for (const int var : scc) {
 			const std::vector<int> &predecessors = causal_graph.get_predecessors(var);
 			for (const int pred : predecessors) {
-				if (std::find(scc.begin(), scc.end(), pred) == scc.end()) {
+				if (scc.find(pred) == scc.end()) {
 					all_contained = false;
 					break;
 				}
@@ -74,7 +77,7 @@ inline auto get_scc_levels(std::vector<std::set<int>> sccs) -> std::vector<std::
 			}
 			const std::vector<int> &successors = causal_graph.get_successors(var);
 			for (const int succ : successors) {
-				if (std::find(scc.begin(), scc.end(), succ) == scc.end()) {
+				if (scc.find(succ) == scc.end()) {
 					has_successors = true;
 				}
 			}
@@ -93,6 +96,12 @@ inline auto get_scc_levels(std::vector<std::set<int>> sccs) -> std::vector<std::
 		}
 	}
 
+	// level of the SCC of each variable whose SCC already has a level
+	std::vector<int> var_lvl(g_root_task()->get_num_variables(), -1);
+	for (const auto &scc : sccs_per_level[0])
+		for (const int var : scc)
+			var_lvl[var] = 0;
+
 	// TODO this is still not working 100% correct in all cases!
 	// if some SCC with real lvl x is checked before his predecessor SCC x-1
 	// it might get lvl x-1 if it has another predecessor with lvl x-2
@@ -101,31 +110,19 @@ inline auto get_scc_levels(std::vector<std::set<int>> sccs) -> std::vector<std::
 		if (root_sccs.find(sccs[i]) != root_sccs.end() || not_connected_sccs.find(sccs[i]) != not_connected_sccs.end()) {
 			continue;
 		}
-		bool got_lvl = false;
+		// the first variable with a predecessor in an SCC that already has a level determines the level
 		for (const int var : sccs[i]) {
-			for (int lvl = sccs_per_level.size() - 1; lvl >= 0; --lvl) {
-				for (const auto &scc : sccs_per_level[lvl]) {
-					for (const int ref : scc) {
-						const std::vector<int> &successors = causal_graph.get_successors(ref);
-						if (std::find(successors.begin(), successors.end(), var) != successors.end()) {
-							std::size_t new_lvl = lvl + 1;
-							if (new_lvl >= sccs_per_level.size()) {
-								sccs_per_level.resize(new_lvl + 1);
-							}
-							sccs_per_level[new_lvl].push_back(sccs[i]);
-							got_lvl = true;
-							break;
-						}
-					}
-					if (got_lvl) {
-						break;
-					}
-				}
-				if (got_lvl) {
-					break;
+			int max_pred_lvl = -1;
+			for (const int pred : causal_graph.get_predecessors(var))
+				max_pred_lvl = std::max(max_pred_lvl, var_lvl[pred]);
+			if (max_pred_lvl != -1) {
+				std::size_t new_lvl = max_pred_lvl + 1;
+				if (new_lvl >= sccs_per_level.size()) {
+					sccs_per_level.resize(new_lvl + 1);
 				}
-			}
-			if (got_lvl) {
+				sccs_per_level[new_lvl].push_back(sccs[i]);
+				for (const int scc_var : sccs[i])
+					var_lvl[scc_var] = new_lvl;
 				break;
 			}
 		}
@@ -0,0 +1,129 @@
+#include "portfolio_redblack_search.h"
+
+#include "incremental_redblack_search.h"
+#include "shared_task_data.h"
+#include "../globals.h"
+#include "../options/option_parser.h"
+#include "../task_utils/causal_graph.h"
+
+#include <algorithm>
+#include <set>
+#include <thread>
+
+
+namespace redblack {
+
+PortfolioRedBlackSearch::PortfolioRedBlackSearch(const options::Options &opts)
+	: SearchEngine<GlobalState, GlobalOperator>(opts),
+	  engines(),
+	  engine_statuses(),
+	  stop_workers(false),
+	  solution_mutex(),
+	  best_plan_cost(bound),
+	  best_engine(-1) {
+	for (const auto &engine : opts.get_list<std::shared_ptr<SearchEngine<GlobalState, GlobalOperator>>>("engines")) {
+		auto rb_engine = std::dynamic_pointer_cast<IncrementalRedBlackSearch>(engine);
+		if (!rb_engine) {
+			std::cerr << "Error: all engines of the red-black portfolio must be incremental_rb engines." << std::endl;
+			utils::exit_with(utils::ExitCode::INPUT_ERROR);
+		}
+		engines.push_back(rb_engine);
+	}
+	// the engines share the axiom evaluator of the global state registries, which is not thread-safe
+	if (has_axioms()) {
+		std::cerr << "Error: the red-black portfolio does not support tasks with axioms." << std::endl;
+		utils::exit_with(utils::ExitCode::UNSUPPORTED);
+	}
+	// heuristics cache their results without synchronization, so every heuristic may only be used by one engine
+	auto used_heuristics = std::set<Heuristic<RBState, RBOperator> *>();
+	for (const auto &engine : engines) {
+		for (auto heuristic : engine->get_rb_heuristics()) {
+			if (!used_heuristics.insert(heuristic).second) {
+				std::cerr << "Error: the engines of the red-black portfolio must not share heuristics." << std::endl;
+				utils::exit_with(utils::ExitCode::INPUT_ERROR);
+			}
+		}
+	}
+	engine_statuses.resize(engines.size(), IN_PROGRESS);
+	// make sure the lazily computed task data is set up before the workers read it concurrently
+	has_conditional_effects();
+	causal_graph::get_causal_graph(g_root_task().get());
+	SharedTaskData::get();
+	std::cout << "Starting red-black portfolio with " << engines.size() << " engines" << std::endl;
+}
+
+void PortfolioRedBlackSearch::run_engine(int index, const WallClockTimer &timer) {
+	auto &engine = *engines[index];
+	// each engine stops at its own max_time, but at the latest at the one of the portfolio
+	const auto engine_max_time = std::min(max_time, engine.get_max_time());
+	auto status = IN_PROGRESS;
+	while (status == IN_PROGRESS && !stop_workers) {
+		status = engine.step();
+		if (status == IN_PROGRESS && timer() >= engine_max_time)
+			status = TIMEOUT;
+	}
+	if (status == SOLVED) {
+		const auto plan_cost = calculate_plan_cost(engine.get_plan());
+		auto lock = std::lock_guard<std::mutex>(solution_mutex);
+		// prefer cheaper plans, break ties in favor of the engine that comes first in the portfolio
+		if (plan_cost < best_plan_cost || (best_engine != -1 && plan_cost == best_plan_cost && index < best_engine)) {
+			best_plan_cost = plan_cost;
+			best_engine = index;
+			stop_workers = true;
+		}
+	}
+	engine_statuses[index] = status;
+}
+
+SearchStatus PortfolioRedBlackSearch::step() {
+	// wall-clock time, the CPU time of the process would add up the time of all workers
+	const auto timer = WallClockTimer();
+	auto workers = std::vector<std::thread>();
+	workers.reserve(engines.size());
+	for (auto i = 0; i < static_cast<int>(engines.size()); ++i)
+		workers.emplace_back(&PortfolioRedBlackSearch::run_engine, this, i, std::cref(timer));
+	for (auto &worker : workers)
+		worker.join();
+	if (best_engine != -1) {
+		std::cout << "Portfolio engine " << best_engine << " found a plan with cost " << best_plan_cost << std::endl;
+		set_plan(engines[best_engine]->get_plan());
+		return SOLVED;
+	}
+	if (std::any_of(std::begin(engine_statuses), std::end(engine_statuses), [](const auto status) { return status == TIMEOUT; }))
+		return TIMEOUT;
+	return FAILED;
+}
+
+void PortfolioRedBlackSearch::print_statistics() const {
+	for (auto i = 0u; i < engines.size(); ++i) {
+		std::cout << "Statistics of portfolio engine " << i << ":" << std::endl;
+		engines[i]->print_statistics();
+	}
+	if (best_engine != -1)
+		std::cout << "Plan found by portfolio engine " << best_engine << std::endl;
+}
+
+void PortfolioRedBlackSearch::add_options_to_parser(options::OptionParser &parser) {
+	parser.document_synopsis("Red-black portfolio search",
+		"Runs each engine in a separate thread and stops all of them as soon as one finds a plan that is cheaper than the bound. "
+		"All engines must be incremental_rb engines. Engines that use randomization should set distinct random_seed values, "
+		"since the default random number generator (random_seed=-1) is shared and not thread-safe. "
+		"For the same reason, each engine needs its own heuristic (do not pass a heuristic predefined with --heuristic to several engines), "
+		"and tasks with axioms are not supported. "
+		"The max_time of the portfolio and the max_time of each engine are measured in wall-clock time from the start of the portfolio.");
+	parser.add_list_option<std::shared_ptr<SearchEngine<GlobalState, GlobalOperator>>>("engines", "incremental red-black search engines to run in parallel");
+}
+
+static std::shared_ptr<SearchEngine<GlobalState, GlobalOperator>> _parse(options::OptionParser &parser) {
+	PortfolioRedBlackSearch::add_options_to_parser(parser);
+	SearchEngine<GlobalState, GlobalOperator>::add_options_to_parser(parser);
+
+	auto opts = parser.parse();
+	opts.verify_list_non_empty<std::shared_ptr<SearchEngine<GlobalState, GlobalOperator>>>("engines");
+	if (parser.help_mode() || parser.dry_run())
+		return nullptr;
+	return std::make_shared<PortfolioRedBlackSearch>(opts);
+}
+
+static options::PluginShared<SearchEngine<GlobalState, GlobalOperator>> _plugin("portfolio_incremental_rb", _parse);
+}
@@ -0,0 +1,51 @@
+#ifndef REDBLACK_PORTFOLIO_RED_BLACK_SEARCH_H
+#define REDBLACK_PORTFOLIO_RED_BLACK_SEARCH_H
+
+#include "util.h"
+#include "../search_engine.h"
+
+#include <atomic>
+#include <mutex>
+
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(default: 4800 4512 4706 4100 4127 4702 4239 4996 4456 4458 4505)
+#endif
+
+namespace options {
+class Options;
+}
+
+namespace redblack {
+class IncrementalRedBlackSearch;
+
+// runs several incremental red-black searches in parallel threads until the first one finds a plan
+class PortfolioRedBlackSearch : public SearchEngine<GlobalState, GlobalOperator> {
+public:
+	explicit PortfolioRedBlackSearch(const options::Options &opts);
+
+	static void add_options_to_parser(options::OptionParser &);
+
+	SearchStatus step() override;
+	void print_statistics() const override;
+
+protected:
+	void run_engine(int index, const WallClockTimer &timer);
+
+	std::vector<std::shared_ptr<IncrementalRedBlackSearch>> engines;
+	std::vector<SearchStatus> engine_statuses;
+
+	// shared between the worker threads, best_plan_cost and best_engine are guarded by solution_mutex
+	std::atomic<bool> stop_workers;
+	std::mutex solution_mutex;
+	int best_plan_cost;
+	int best_engine;
+};
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
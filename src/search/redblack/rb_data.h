@@ -4,6 +4,7 @@
 #include "painting.h"
 #include "int_packer.h"
 #include "state_registry.h"
+#include "state_saturation.h"
 #include "../globals.h"
 
 namespace redblack {
@@ -17,8 +18,12 @@ struct RBData {
 		int_packer.initialize(g_variable_domain);
 	}
 
-	auto construct_state_registry(const std::vector<int> &initial_state_data) const -> std::unique_ptr<RBStateRegistry> {
-		return std::make_unique<RBStateRegistry>(*g_root_task(), int_packer, *g_axiom_evaluator, initial_state_data);
+	auto construct_state_registry(const std::vector<int> &initial_state_data,
+	                              StateSaturationType state_saturation_type = StateSaturationType::COUNTERS,
+	                              bool incremental_saturation = true,
+	                              bool compress_states = false,
+	                              bool time_applicable_ops = false) const -> std::unique_ptr<RBStateRegistry> {
+		return std::make_unique<RBStateRegistry>(*g_root_task(), int_packer, *g_axiom_evaluator, initial_state_data, state_saturation_type, incremental_saturation, compress_states, time_applicable_ops);
 	}
 };
 }
@@ -4,6 +4,10 @@
 #include "state.h"
 #include "operator.h"
 #include "../options/plugin.h"
+#include "../utils/collections.h"
+
+#include <algorithm>
+#include <iostream>
 
 namespace additive_heuristic {
 template<>
@@ -15,10 +19,9 @@ auto AdditiveHeuristic<redblack::RBState, redblack::RBOperator>::convert_state(c
 template<>
 template<>
 void AdditiveHeuristic<redblack::RBState, redblack::RBOperator>::setup_exploration_queue_state(const redblack::RBState &state) {
-	for (auto i = 0; i < task->get_num_variables(); ++i)
-		for (auto j = 0; j < task->get_variable_domain_size(i); ++j)
-			if (state.has_fact(i, j))
-				enqueue_if_necessary(get_proposition(FactProxy(*task, i, j)), 0, nullptr);
+	state.for_each_fact([this](int var, int value) {
+		enqueue_if_necessary(&propositions[var][value], 0, nullptr);
+	});
 }
 
 template<>
@@ -42,6 +45,93 @@ void AdditiveHeuristic<redblack::RBState, redblack::RBOperator>::compute_heurist
 }
 
 namespace redblack {
+RBFFHeuristic::RBFFHeuristic(const options::Options &opts)
+	: FFHeuristic(opts),
+	  max_cached_estimates(opts.get<int>("max_cached_estimates")),
+	  max_cache_memory(opts.get<int>("max_cache_memory")),
+	  fact_offsets(),
+	  fact_set(),
+	  cached_estimates(),
+	  cached_estimates_bytes(0),
+	  peak_cache_bytes(0),
+	  num_cache_clears(0),
+	  num_searches(0),
+	  num_lookups(0),
+	  num_hits(0),
+	  num_carried_over(0) {
+	fact_offsets.reserve(task_proxy.get_variables().size());
+	auto num_facts = 0;
+	for (auto var : task_proxy.get_variables()) {
+		fact_offsets.push_back(num_facts);
+		num_facts += var.get_domain_size();
+	}
+	fact_set.resize((num_facts + 63) / 64);
+}
+
+void RBFFHeuristic::set_fact_set(const RBState &state) {
+	std::fill(std::begin(fact_set), std::end(fact_set), 0);
+	state.for_each_fact([this](int var, int value) {
+		const auto fact = fact_offsets[var] + value;
+		fact_set[fact / 64] |= std::uint64_t(1) << (fact % 64);
+	});
+}
+
+auto RBFFHeuristic::estimate_entry_bytes(const CachedEstimate &estimate) const -> std::size_t {
+	// the hash node with its next pointer and allocation overhead, and the contents of both vectors
+	return sizeof(decltype(cached_estimates)::value_type) + 3 * sizeof(void *)
+		+ utils::estimate_vector_bytes<std::uint64_t>(fact_set.size()) - sizeof(FactSet)
+		+ utils::estimate_vector_bytes<OperatorID>(estimate.preferred_operators.size()) - sizeof(std::vector<OperatorID>);
+}
+
+auto RBFFHeuristic::estimate_cache_bytes() const -> std::size_t {
+	return cached_estimates_bytes + cached_estimates.bucket_count() * sizeof(void *);
+}
+
+auto RBFFHeuristic::compute_heuristic(const RBState &state) -> int {
+	if (max_cached_estimates == 0)
+		return FFHeuristic::compute_heuristic(state);
+	++num_lookups;
+	set_fact_set(state);
+	const auto cached_estimate = cached_estimates.find(fact_set);
+	if (cached_estimate != std::end(cached_estimates)) {
+		++num_hits;
+		if (cached_estimate->second.search != num_searches)
+			++num_carried_over;
+		for (auto op_id : cached_estimate->second.preferred_operators)
+			if (is_operator_applicable(state, op_id.get_index()))
+				set_preferred(task_proxy.get_operators()[op_id.get_index()]);
+		return cached_estimate->second.h;
+	}
+	const auto h = FFHeuristic::compute_heuristic(state);
+	const auto &preferred_operators = get_preferred_operators();
+	auto estimate = CachedEstimate{h, num_searches, {std::begin(preferred_operators), std::end(preferred_operators)}};
+	const auto entry_bytes = estimate_entry_bytes(estimate);
+	if (static_cast<int>(cached_estimates.size()) >= max_cached_estimates
+		|| (max_cache_memory != -1 && estimate_cache_bytes() + entry_bytes > static_cast<std::size_t>(max_cache_memory) * 1024 * 1024)) {
+		// clearing the map keeps its buckets, so release them as well
+		decltype(cached_estimates)().swap(cached_estimates);
+		cached_estimates_bytes = 0;
+		++num_cache_clears;
+	}
+	cached_estimates.emplace(fact_set, std::move(estimate));
+	cached_estimates_bytes += entry_bytes;
+	peak_cache_bytes = std::max(peak_cache_bytes, estimate_cache_bytes());
+	return h;
+}
+
+void RBFFHeuristic::notify_initial_state(const RBState &) {
+	++num_searches;
+}
+
+void RBFFHeuristic::print_statistics() const {
+	if (max_cached_estimates == 0)
+		return;
+	std::cout << "Cached red-black FF estimates: " << num_hits << "/" << num_lookups << " hits, "
+		<< num_carried_over << " carried over from earlier red-black searches" << std::endl;
+	std::cout << "Red-black FF estimate cache: " << cached_estimates.size() << " entries, "
+		<< estimate_cache_bytes() / 1024 << " KB (peak: " << peak_cache_bytes / 1024 << " KB), cleared " << num_cache_clears << " times" << std::endl;
+}
+
 static Heuristic<RBState, RBOperator> *_parse(options::OptionParser &parser) {
     parser.document_synopsis("FF heuristic", "See also Synergy.");
     parser.document_language_support("action costs", "supported");
@@ -57,11 +147,15 @@ static Heuristic<RBState, RBOperator> *_parse(options::OptionParser &parser) {
     parser.document_property("preferred operators", "yes");
 
     Heuristic<RBState, RBOperator>::add_options_to_parser(parser);
+	parser.add_option<int>("max_cached_estimates", "maximum number of estimates that are cached by the facts of the state, "
+		"the cache is cleared when it is full (0 disables the cache)", "0", options::Bounds("0", "infinity"));
+	parser.add_option<int>("max_cache_memory", "maximum estimated memory in MB of the cached estimates, "
+		"the cache is cleared when it would be exceeded (-1 for no limit)", "256", options::Bounds("-1", "infinity"));
 	options::Options opts = parser.parse();
     if (parser.dry_run())
         return 0;
     else
-        return new ff_heuristic::FFHeuristic<RBState, RBOperator>(opts);
+        return new RBFFHeuristic(opts);
 }
 
 static options::Plugin<Heuristic<RBState, RBOperator>> _plugin("ff_rb", _parse);
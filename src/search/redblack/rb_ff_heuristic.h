@@ -2,6 +2,9 @@
 #define REDBLACK_RB_FF_HEURISTIC_H
 
 #include "../heuristics/ff_heuristic.h"
+#include "../utils/hash.h"
+
+#include <cstdint>
 
 namespace redblack {
 class RBState;
@@ -12,7 +15,7 @@ namespace additive_heuristic {
 
 template<>
 template<>
-auto AdditiveHeuristic<redblack::RBState, redblack::RBOperator>::convert_state(const redblack::RBState &state);
+auto AdditiveHeuristic<redblack::RBState, redblack::RBOperator>::convert_state(const redblack::RBState &state) -> redblack::RBState;
 
 template<>
 template<>
@@ -30,5 +33,52 @@ void AdditiveHeuristic<redblack::RBState, redblack::RBOperator>::compute_heurist
 
 }
 
+namespace redblack {
+// The FF estimate of a red-black state only depends on its facts, not on the painting.
+// The estimates can be cached by fact set, so they carry over to the later red-black searches of an incremental search.
+// The cache is disabled by default, since it keeps a copy of the facts of every evaluated state.
+class RBFFHeuristic : public ff_heuristic::FFHeuristic<RBState, RBOperator> {
+	using FactSet = std::vector<std::uint64_t>;
+
+	struct CachedEstimate {
+		int h;
+		// the red-black search in which the estimate was computed
+		int search;
+		// the preferred operators in the painting of that search, these are only a subset of the
+		// preferred operators in a painting with more black variables
+		std::vector<OperatorID> preferred_operators;
+	};
+
+	const int max_cached_estimates;
+	// -1 for no limit
+	const int max_cache_memory;
+	std::vector<int> fact_offsets;
+	FactSet fact_set;
+	utils::HashMap<FactSet, CachedEstimate> cached_estimates;
+	// estimated memory of the cached entries (without the bucket array)
+	std::size_t cached_estimates_bytes;
+	std::size_t peak_cache_bytes;
+	int num_cache_clears;
+	int num_searches;
+
+	int num_lookups;
+	int num_hits;
+	int num_carried_over;
+
+	void set_fact_set(const RBState &state);
+	auto estimate_entry_bytes(const CachedEstimate &estimate) const -> std::size_t;
+	auto estimate_cache_bytes() const -> std::size_t;
+
+protected:
+	auto compute_heuristic(const RBState &state) -> int override;
+
+public:
+	explicit RBFFHeuristic(const options::Options &opts);
+
+	void notify_initial_state(const RBState &initial_state) override;
+
+	void print_statistics() const;
+};
+}
 
 #endif
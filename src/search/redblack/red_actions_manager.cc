@@ -1,12 +1,20 @@
 #include "red_actions_manager.h"
 
 #include "operator.h"
+#include "shared_task_data.h"
+#include "../globals.h"
+#include "../utils/collections.h"
 
 namespace redblack {
 
 RedActionsManager::RedActionsManager(const std::vector<RBOperator> &operators)
 	: red_operators(operators.size()),
-	  conditionally_red_operators() {
+	  match_tree(),
+	  matched_operators(),
+	  open_nodes(),
+	  condition_variables(),
+	  cache() {
+	auto conditionally_red_operator_indices = std::unordered_map<std::vector<FactPair>, boost::dynamic_bitset<>>();
 	for (auto i = 0u; i < operators.size(); ++i) {
 		const auto &op = operators[i];
 		if (op.get_red_effects().empty())
@@ -17,9 +25,10 @@ RedActionsManager::RedActionsManager(const std::vector<RBOperator> &operators)
 		// c) always modifies black variables ==> ignore this operator
 		auto changes_black_variable = false;
 		auto preconditions = std::vector<FactPair>();
-		for (const auto &precondition : op.get_black_preconditions())
-			preconditions.emplace_back(precondition->var, precondition->val);
-		std::sort(std::begin(preconditions), std::end(preconditions));
+		preconditions.reserve(op.get_black_preconditions().size() + op.get_black_effects().size());
+		for (const auto &precondition : SharedTaskData::get().get_sorted_preconditions(op.get_id().get_index()))
+			if (op.get_painting().is_black_var(precondition.var))
+				preconditions.push_back(precondition);
 		for (const auto effect : op.get_black_effects()) {
 			assert(std::none_of(std::begin(op.get_black_preconditions()), std::end(op.get_black_preconditions()), [effect](const auto precondition) {
 				return precondition->var == effect->var && precondition->val == effect->val;
@@ -46,34 +55,154 @@ RedActionsManager::RedActionsManager(const std::vector<RBOperator> &operators)
 		if (preconditions.empty()) {
 			red_operators[i] = true;
 		} else {
-			auto insertion_result = conditionally_red_operators.try_emplace(std::move(preconditions), operators.size());
+			auto insertion_result = conditionally_red_operator_indices.try_emplace(std::move(preconditions), operators.size());
 			insertion_result.first->second[i] = true;
 		}
 	}
+	if (conditionally_red_operator_indices.empty())
+		return;
+	// sort the groups to make the tree independent of the hash map's iteration order
+	auto conditionally_red_operators = std::vector<std::pair<std::vector<FactPair>, boost::dynamic_bitset<>>>(
+		std::begin(conditionally_red_operator_indices), std::end(conditionally_red_operator_indices));
+	std::sort(std::begin(conditionally_red_operators), std::end(conditionally_red_operators),
+		[](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+	auto is_condition_variable = std::vector<bool>(g_root_task()->get_num_variables(), false);
+	for (const auto &[conditions, group_operators] : conditionally_red_operators)
+		for (const auto &condition : conditions)
+			is_condition_variable[condition.var] = true;
+	for (auto var = 0; var < g_root_task()->get_num_variables(); ++var)
+		if (is_condition_variable[var])
+			condition_variables.push_back(var);
+	auto condition_positions = std::vector<std::pair<int, std::size_t>>();
+	condition_positions.reserve(conditionally_red_operators.size());
+	for (auto i = 0u; i < conditionally_red_operators.size(); ++i)
+		condition_positions.emplace_back(i, 0);
+	add_match_tree_node(conditionally_red_operators, condition_positions);
 }
 
-auto RedActionsManager::get_red_actions_for_state(const GlobalState &state) -> boost::dynamic_bitset<> {
-	return get_red_actions_for_state(state.get_values());
+auto RedActionsManager::add_match_tree_node(const std::vector<std::pair<std::vector<FactPair>, boost::dynamic_bitset<>>> &conditionally_red_operators,
+                                            const std::vector<std::pair<int, std::size_t>> &condition_positions) -> int {
+	// the conditions of each group are sorted by variable, so the groups branch on the smallest variable of their next condition
+	const auto node_index = static_cast<int>(match_tree.size());
+	match_tree.push_back({-1, -1, {}, -1});
+	auto matched = boost::dynamic_bitset<>();
+	auto var = std::numeric_limits<int>::max();
+	for (const auto &[group, position] : condition_positions) {
+		const auto &[conditions, group_operators] = conditionally_red_operators[group];
+		if (position == conditions.size()) {
+			if (matched.empty())
+				matched.resize(group_operators.size());
+			matched |= group_operators;
+		} else {
+			var = std::min(var, conditions[position].var);
+		}
+	}
+	if (!matched.empty()) {
+		match_tree[node_index].matched = matched_operators.size();
+		matched_operators.push_back(std::move(matched));
+	}
+	if (var == std::numeric_limits<int>::max())
+		return node_index;
+	auto value_positions = std::vector<std::vector<std::pair<int, std::size_t>>>(g_root_task()->get_variable_domain_size(var));
+	auto dont_care_positions = std::vector<std::pair<int, std::size_t>>();
+	for (const auto &[group, position] : condition_positions) {
+		const auto &conditions = conditionally_red_operators[group].first;
+		if (position == conditions.size())
+			continue;
+		if (conditions[position].var == var)
+			value_positions[conditions[position].value].emplace_back(group, position + 1);
+		else
+			dont_care_positions.emplace_back(group, position);
+	}
+	auto value_children = std::vector<int>(value_positions.size(), -1);
+	for (auto value = 0u; value < value_positions.size(); ++value)
+		if (!value_positions[value].empty())
+			value_children[value] = add_match_tree_node(conditionally_red_operators, value_positions[value]);
+	const auto dont_care_child = dont_care_positions.empty() ? -1 : add_match_tree_node(conditionally_red_operators, dont_care_positions);
+	auto &node = match_tree[node_index];
+	node.var = var;
+	node.value_children = std::move(value_children);
+	node.dont_care_child = dont_care_child;
+	return node_index;
 }
 
-auto RedActionsManager::get_red_actions_for_state(const std::vector<int> &state_values) -> boost::dynamic_bitset<> {
+template<typename StateType>
+auto RedActionsManager::get_cached_red_actions(const StateType &state) -> boost::dynamic_bitset<> {
+	if (match_tree.empty())
+		return red_operators;
+	auto key = std::vector<int>();
+	key.reserve(condition_variables.size());
+	for (const auto var : condition_variables)
+		key.push_back(state[var]);
+	const auto cached = cache.find(key);
+	if (cached != std::end(cache))
+		return cached->second;
 	auto result = red_operators;
-	for (const auto &conditionally_red_operator : conditionally_red_operators) {
-		assert(conditionally_red_operator.second.any());
-		if (std::all_of(std::begin(conditionally_red_operator.first), std::end(conditionally_red_operator.first), [&state_values](const auto &precondition) { return state_values[precondition.var] == precondition.value; }))
-			result |= conditionally_red_operator.second;
+	assert(open_nodes.empty());
+	open_nodes.push_back(0);
+	while (!open_nodes.empty()) {
+		const auto &node = match_tree[open_nodes.back()];
+		open_nodes.pop_back();
+		if (node.matched != -1)
+			result |= matched_operators[node.matched];
+		if (node.var == -1)
+			continue;
+		if (node.value_children[state[node.var]] != -1)
+			open_nodes.push_back(node.value_children[state[node.var]]);
+		if (node.dont_care_child != -1)
+			open_nodes.push_back(node.dont_care_child);
 	}
+	if (cache.size() >= MAX_CACHE_SIZE)
+		cache.clear();
+	cache.emplace(std::move(key), result);
 	return result;
 }
 
+auto RedActionsManager::get_red_actions_for_state(const GlobalState &state) -> boost::dynamic_bitset<> {
+	return get_cached_red_actions(state);
+}
+
+auto RedActionsManager::get_red_actions_for_state(const std::vector<int> &state_values) -> boost::dynamic_bitset<> {
+	return get_cached_red_actions(state_values);
+}
+
 auto RedActionsManager::get_red_actions_for_state(const std::vector<boost::dynamic_bitset<>> &state) -> boost::dynamic_bitset<> {
+	// red-black states may satisfy conditions on several values of a variable, so all matching branches are followed
 	auto result = red_operators;
-	for (const auto &conditionally_red_operator : conditionally_red_operators) {
-		assert(conditionally_red_operator.second.any());
-		if (std::all_of(std::begin(conditionally_red_operator.first), std::end(conditionally_red_operator.first), [&state](const auto &precondition) { return state[precondition.var][precondition.value]; }))
-			result |= conditionally_red_operator.second;
+	if (match_tree.empty())
+		return result;
+	assert(open_nodes.empty());
+	open_nodes.push_back(0);
+	while (!open_nodes.empty()) {
+		const auto &node = match_tree[open_nodes.back()];
+		open_nodes.pop_back();
+		if (node.matched != -1)
+			result |= matched_operators[node.matched];
+		if (node.var == -1)
+			continue;
+		for (auto value = 0u; value < node.value_children.size(); ++value)
+			if (node.value_children[value] != -1 && state[node.var][value])
+				open_nodes.push_back(node.value_children[value]);
+		if (node.dont_care_child != -1)
+			open_nodes.push_back(node.dont_care_child);
 	}
 	return result;
 }
 
+auto RedActionsManager::estimate_memory_usage() const -> std::size_t {
+	using Block = boost::dynamic_bitset<>::block_type;
+	auto bytes = std::size_t(utils::estimate_vector_bytes<Block>(red_operators.num_blocks()));
+	bytes += utils::estimate_vector_bytes<MatchTreeNode>(match_tree.size());
+	for (const auto &node : match_tree)
+		bytes += utils::estimate_vector_bytes<int>(node.value_children.size());
+	bytes += utils::estimate_vector_bytes<boost::dynamic_bitset<>>(matched_operators.size());
+	for (const auto &operators : matched_operators)
+		bytes += utils::estimate_vector_bytes<Block>(operators.num_blocks());
+	bytes += utils::estimate_vector_bytes<int>(condition_variables.size());
+	bytes += utils::estimate_unordered_map_bytes<std::vector<int>, boost::dynamic_bitset<>>(cache.size());
+	for (const auto &[values, operators] : cache)
+		bytes += utils::estimate_vector_bytes<int>(values.size()) + utils::estimate_vector_bytes<Block>(operators.num_blocks());
+	return bytes;
+}
+
 }
@@ -10,8 +10,33 @@
 namespace redblack {
 
 class RedActionsManager {
+	static constexpr std::size_t MAX_CACHE_SIZE = 10000;
+
+	// match tree over the black conditions of the conditionally red operators, similar to the successor generator
+	struct MatchTreeNode {
+		// -1 for leaves
+		int var;
+		// index into matched_operators of the operators whose conditions are all satisfied when reaching this node, -1 if there are none
+		int matched;
+		// -1 if no condition requires the respective value
+		std::vector<int> value_children;
+		int dont_care_child;
+	};
+
 	boost::dynamic_bitset<> red_operators;
-	std::unordered_map<std::vector<FactPair>, boost::dynamic_bitset<>> conditionally_red_operators;
+	std::vector<MatchTreeNode> match_tree;
+	std::vector<boost::dynamic_bitset<>> matched_operators;
+	std::vector<int> open_nodes;
+
+	// results for the values of condition_variables, cleared when it grows beyond MAX_CACHE_SIZE
+	std::vector<int> condition_variables;
+	std::unordered_map<std::vector<int>, boost::dynamic_bitset<>> cache;
+
+	auto add_match_tree_node(const std::vector<std::pair<std::vector<FactPair>, boost::dynamic_bitset<>>> &conditionally_red_operators,
+	                         const std::vector<std::pair<int, std::size_t>> &condition_positions) -> int;
+
+	template<typename StateType>
+	auto get_cached_red_actions(const StateType &state) -> boost::dynamic_bitset<>;
 
 public:
 	RedActionsManager(const std::vector<RBOperator> &operators);
@@ -19,6 +44,8 @@ public:
 	auto get_red_actions_for_state(const GlobalState &state) -> boost::dynamic_bitset<>;
 	auto get_red_actions_for_state(const std::vector<int> &state_values) -> boost::dynamic_bitset<>;
 	auto get_red_actions_for_state(const std::vector<boost::dynamic_bitset<>> &state) -> boost::dynamic_bitset<>;
+
+	auto estimate_memory_usage() const -> std::size_t;
 };
 }
 
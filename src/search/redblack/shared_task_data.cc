@@ -0,0 +1,81 @@
+#include "shared_task_data.h"
+
+#include "painting_utils.h"
+#include "../globals.h"
+#include "../global_operator.h"
+#include "../utils/collections.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace redblack {
+
+SharedTaskData::SharedTaskData()
+	: precondition_table(),
+	  precondition_offsets(),
+	  effect_table(),
+	  effect_offsets(),
+	  sorted_preconditions(),
+	  fact_index_offset(),
+	  num_facts(0) {
+	precondition_offsets.reserve(g_operators.size() + 1);
+	effect_offsets.reserve(g_operators.size() + 1);
+	sorted_preconditions.reserve(g_operators.size());
+	for (const auto &op : g_operators) {
+		precondition_offsets.push_back(precondition_table.size());
+		for (const auto &precondition : op.get_preconditions())
+			precondition_table.push_back(&precondition);
+		effect_offsets.push_back(effect_table.size());
+		for (const auto &effect : op.get_effects())
+			effect_table.push_back(&effect);
+		auto preconditions = std::vector<FactPair>();
+		preconditions.reserve(op.get_preconditions().size());
+		for (const auto &precondition : op.get_preconditions())
+			preconditions.emplace_back(precondition.var, precondition.val);
+		std::sort(std::begin(preconditions), std::end(preconditions));
+		sorted_preconditions.push_back(std::move(preconditions));
+	}
+	precondition_offsets.push_back(precondition_table.size());
+	effect_offsets.push_back(effect_table.size());
+	fact_index_offset.reserve(g_root_task()->get_num_variables());
+	for (auto var = 0; var < g_root_task()->get_num_variables(); ++var) {
+		fact_index_offset.push_back(num_facts);
+		num_facts += g_root_task()->get_variable_domain_size(var);
+	}
+}
+
+auto SharedTaskData::get() -> const SharedTaskData & {
+	static const auto shared_task_data = SharedTaskData();
+	return shared_task_data;
+}
+
+auto SharedTaskData::estimate_memory_usage() const -> std::size_t {
+	auto bytes = utils::estimate_vector_bytes<const GlobalCondition *>(precondition_table.size())
+		+ utils::estimate_vector_bytes<std::size_t>(precondition_offsets.size())
+		+ utils::estimate_vector_bytes<const GlobalEffect *>(effect_table.size())
+		+ utils::estimate_vector_bytes<std::size_t>(effect_offsets.size());
+	for (const auto &preconditions : sorted_preconditions)
+		bytes += utils::estimate_vector_bytes<FactPair>(preconditions.size());
+	return bytes + utils::estimate_vector_bytes<std::size_t>(fact_index_offset.size());
+}
+
+CausalGraphSCCs::CausalGraphSCCs()
+	: sccs(rbutils::get_sccs({})),
+	  sccs_per_level(rbutils::get_scc_levels(sccs)),
+	  variable_levels(g_root_task()->get_num_variables(), -1) {
+	for (auto lvl = 0; lvl < static_cast<int>(sccs_per_level.size()); ++lvl) {
+		for (const auto &scc : sccs_per_level[lvl]) {
+			for (auto var : scc) {
+				assert(variable_levels[var] == -1);
+				variable_levels[var] = lvl;
+			}
+		}
+	}
+}
+
+auto CausalGraphSCCs::get() -> const CausalGraphSCCs & {
+	static const auto causal_graph_sccs = CausalGraphSCCs();
+	return causal_graph_sccs;
+}
+
+}
@@ -0,0 +1,96 @@
+#ifndef REDBLACK_SHARED_TASK_DATA_H
+#define REDBLACK_SHARED_TASK_DATA_H
+
+#include "../abstract_task.h"
+
+#include <set>
+#include <vector>
+
+struct GlobalCondition;
+struct GlobalEffect;
+
+namespace redblack {
+// contiguous part of a shared table
+template<class Element>
+class TableSpan {
+	const Element *first;
+	const Element *last;
+
+public:
+	TableSpan(const Element *first, const Element *last)
+		: first(first),
+		  last(last) {}
+
+	auto begin() const -> const Element * { return first; }
+	auto end() const -> const Element * { return last; }
+	auto size() const -> std::size_t { return last - first; }
+	auto empty() const -> bool { return first == last; }
+};
+
+/*
+  Painting-independent data about the operators and facts of the task. It is
+  computed once and shared by the state registries and state saturations of
+  all paintings, which only derive their painting-specific parts from it.
+*/
+class SharedTaskData {
+	// preconditions and effects of all operators in their original order, the entries of operator i start at offset i
+	std::vector<const GlobalCondition *> precondition_table;
+	std::vector<std::size_t> precondition_offsets;
+	std::vector<const GlobalEffect *> effect_table;
+	std::vector<std::size_t> effect_offsets;
+	// preconditions of each operator, sorted
+	std::vector<std::vector<FactPair>> sorted_preconditions;
+	std::vector<std::size_t> fact_index_offset;
+	std::size_t num_facts;
+
+	SharedTaskData();
+
+public:
+	static auto get() -> const SharedTaskData &;
+
+	auto get_preconditions(int op_index) const -> TableSpan<const GlobalCondition *> {
+		return {precondition_table.data() + precondition_offsets[op_index], precondition_table.data() + precondition_offsets[op_index + 1]};
+	}
+
+	auto get_effects(int op_index) const -> TableSpan<const GlobalEffect *> {
+		return {effect_table.data() + effect_offsets[op_index], effect_table.data() + effect_offsets[op_index + 1]};
+	}
+
+	auto get_sorted_preconditions(int op_index) const -> const std::vector<FactPair> & {
+		return sorted_preconditions[op_index];
+	}
+
+	auto get_fact_index(int var, int val) const -> std::size_t {
+		return fact_index_offset[var] + val;
+	}
+
+	auto get_num_facts() const -> std::size_t {
+		return num_facts;
+	}
+
+	auto estimate_memory_usage() const -> std::size_t;
+};
+
+/*
+  The strongly connected components of the causal graph and their levels. They
+  are computed once and shared by the painting factories and the incremental
+  painting strategies.
+*/
+class CausalGraphSCCs {
+	std::vector<std::set<int>> sccs;
+	std::vector<std::vector<std::set<int>>> sccs_per_level;
+	// level of the SCC of each variable, -1 if the SCC has no level
+	std::vector<int> variable_levels;
+
+	CausalGraphSCCs();
+
+public:
+	static auto get() -> const CausalGraphSCCs &;
+
+	auto get_sccs() const -> const std::vector<std::set<int>> & { return sccs; }
+	auto get_sccs_per_level() const -> const std::vector<std::vector<std::set<int>>> & { return sccs_per_level; }
+	auto get_variable_levels() const -> const std::vector<int> & { return variable_levels; }
+};
+}
+
+#endif
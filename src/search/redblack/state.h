@@ -19,10 +19,7 @@ class RBState : public StateBase<RBStateRegistryBase> {
 	friend RBStateRegistry;
 
 	// Only used by the (red-black) state registry.
-	RBState(const PackedStateBin *buffer, const RBStateRegistryBase &registry, StateID id, const Painting &painting, const RBIntPacker &int_packer);
-
-	const Painting * painting;
-	const RBIntPacker * int_packer;
+	RBState(const PackedStateBin *buffer, const RBStateRegistry &registry, StateID id);
 
 public:
 	~RBState() = default;
@@ -33,25 +30,61 @@ public:
 	auto operator=(const RBState &other) -> RBState & = default;
 	auto operator=(RBState &&other) -> RBState & = default;
 
-	int operator[](int var) const override;
-	auto has_fact(int var, int value) const -> bool;
+	// only for black variables
+	int operator[](int var) const {
+		assert(get_painting().is_black_var(var));
+		return StateBase<RBStateRegistryBase>::operator[](var);
+	}
+
+	auto has_fact(int var, int value) const -> bool {
+		return get_painting().is_red_var(var) ? get_rb_state_registry().rb_state_packer().get_bit(buffer, var, value) : StateBase<RBStateRegistryBase>::operator[](var) == value;
+	}
 
+	// red-black states are only created by RBStateRegistry
 	auto get_rb_state_registry() const -> const RBStateRegistry & {
 		assert(dynamic_cast<const RBStateRegistry *>(registry));
-		return *dynamic_cast<const RBStateRegistry *>(registry);
+		return *static_cast<const RBStateRegistry *>(registry);
 	}
 
 	auto get_painting() const -> const Painting & {
-		return *painting;
+		return get_rb_state_registry().get_painting();
 	}
 
-	std::vector<int> get_values() const override;
+	// calls callback(var, value) for every fact of the state, the values of red variables are read word by word
+	template<class Callback>
+	void for_each_fact(const Callback &callback) const;
+
+	std::vector<int> get_values() const;
 	auto get_redblack_values() const -> std::vector<boost::dynamic_bitset<>>;
 
-	void dump_pddl() const override;
-	void dump_fdr() const override;
+	void dump_pddl() const;
+	void dump_fdr() const;
 
 };
+
+namespace detail {
+template<class Callback>
+void for_each_value_in_word(PackedStateBin bits, int var, int first_value, const Callback &callback) {
+	for (auto value = first_value; bits; ++value, bits >>= 1)
+		if (bits & 1)
+			callback(var, value);
+}
+}
+
+template<class Callback>
+void RBState::for_each_fact(const Callback &callback) const {
+	const auto &packer = get_rb_state_registry().rb_state_packer();
+	const auto &painting = get_painting();
+	for (auto var = 0; var < static_cast<int>(painting.get_painting().size()); ++var) {
+		if (painting.is_black_var(var)) {
+			callback(var, packer.get(buffer, var));
+			continue;
+		}
+		for (auto word = 0; word < packer.get_num_red_words(var); ++word)
+			detail::for_each_value_in_word(packer.get_red_word(buffer, var, word), var, word * RBIntPacker::BITS_PER_RED_WORD, callback);
+	}
+}
+
 }
 
 #endif
@@ -3,9 +3,12 @@
 #include "operator.h"
 #include "state.h"
 #include "state_saturation.h"
+#include "util.h"
 
 #include "../tasks/cost_adapted_task.h"
 #include "../globals.h"
+#include "../task_proxy.h"
+#include "../utils/collections.h"
 
 #include <map>
 
@@ -24,7 +27,13 @@ auto StateRegistryBase<redblack::RBState, redblack::RBOperator>::get_successor_s
 
 namespace redblack {
 
-auto RBStateRegistry::get_state_saturation(const AbstractTask &task, const RBIntPacker &state_packer, const std::vector<RBOperator> &operators) -> std::unique_ptr<StateSaturation> {
+auto RBStateRegistry::get_state_saturation(const AbstractTask &task, const RBIntPacker &state_packer, const std::vector<RBOperator> &operators,
+                                           StateSaturationType state_saturation_type) -> std::unique_ptr<StateSaturation> {
+	if (state_saturation_type == StateSaturationType::FLAT_COUNTERS) {
+		if (has_conditional_effects())
+			return std::make_unique<FlatCounterStateSaturation<true>>(task, state_packer, operators);
+		return std::make_unique<FlatCounterStateSaturation<false>>(task, state_packer, operators);
+	}
 	if (has_conditional_effects())
 		return std::make_unique<CounterBasedStateSaturation<true>>(task, state_packer, operators);
 	return std::make_unique<CounterBasedStateSaturation<false>>(task, state_packer, operators);
@@ -33,42 +42,50 @@ auto RBStateRegistry::get_state_saturation(const AbstractTask &task, const RBInt
 auto RBStateRegistry::construct_redblack_operators(const Painting &painting) -> std::vector<RBOperator> {
 	auto rb_operators = std::vector<RBOperator>();
 	rb_operators.reserve(g_operators.size());
-	for (const auto &op : g_operators) {
-		rb_operators.emplace_back(op);
-		rb_operators.back().apply_painting(painting);
-	}
+	for (const auto &op : g_operators)
+		rb_operators.emplace_back(op, painting);
 	return rb_operators;
 }
 
 RBStateRegistry::RBStateRegistry(const AbstractTask &task, const RBIntPacker &state_packer,
 	                             AxiomEvaluator &axiom_evaluator, std::vector<int> &&initial_state_data,
-	                             PackedStateBin *rb_initial_state_data)
-	: StateRegistryBase<RBState, RBOperator>(task, state_packer, axiom_evaluator, std::move(initial_state_data)),
+	                             StateSaturationType state_saturation_type, bool incremental_saturation,
+	                             bool compress_states, bool time_applicable_ops, PackedStateBin *rb_initial_state_data)
+	: StateRegistryBase<RBState, RBOperator>(task, state_packer, axiom_evaluator, std::move(initial_state_data), compress_states),
 	  painting(&state_packer.get_painting()),
 	  operators(construct_redblack_operators(*painting)),
 	  initial_state_best_supporters(),
-	  state_saturation(get_state_saturation(task, state_packer, this->operators)) {
+	  state_saturation(get_state_saturation(task, state_packer, this->operators, state_saturation_type)),
+	  incremental_saturation(incremental_saturation && !has_axioms()),
+	  successor_new_facts(),
+	  successor_generator(std::make_unique<successor_generator::SuccessorGenerator>(TaskProxy(task), *painting)),
+	  time_applicable_ops(time_applicable_ops),
+	  applicable_ops_time(0) {
 	if (rb_initial_state_data) {
 		// TODO: make sure the passed initial state data matches the painting
-		state_data_pool.push_back(rb_initial_state_data);
-		StateID id = insert_id_or_pop_state();
-		cached_initial_state = new RBState(state_data_pool[id.value], *this, id, *painting, rb_state_packer());
+		StateID id = insert_state(rb_initial_state_data);
+		cached_initial_state = new RBState(lookup_state(id));
 	}
 }
 
 RBStateRegistry::RBStateRegistry(const AbstractTask &task, const RBIntPacker &state_packer,
 	                             AxiomEvaluator &axiom_evaluator, const std::vector<int> &initial_state_data,
-	                             PackedStateBin *rb_initial_state_data)
-	: StateRegistryBase<RBState, RBOperator>(task, state_packer, axiom_evaluator, initial_state_data),
+	                             StateSaturationType state_saturation_type, bool incremental_saturation,
+	                             bool compress_states, bool time_applicable_ops, PackedStateBin *rb_initial_state_data)
+	: StateRegistryBase<RBState, RBOperator>(task, state_packer, axiom_evaluator, initial_state_data, compress_states),
 	  painting(&state_packer.get_painting()),
 	  operators(construct_redblack_operators(*painting)),
 	  initial_state_best_supporters(),
-	  state_saturation(get_state_saturation(task, state_packer, this->operators)) {
+	  state_saturation(get_state_saturation(task, state_packer, this->operators, state_saturation_type)),
+	  incremental_saturation(incremental_saturation && !has_axioms()),
+	  successor_new_facts(),
+	  successor_generator(std::make_unique<successor_generator::SuccessorGenerator>(TaskProxy(task), *painting)),
+	  time_applicable_ops(time_applicable_ops),
+	  applicable_ops_time(0) {
 	if (rb_initial_state_data) {
 		// TODO: make sure the passed initial state data matches the painting
-		state_data_pool.push_back(rb_initial_state_data);
-		StateID id = insert_id_or_pop_state();
-		cached_initial_state = new RBState(state_data_pool[id.value], *this, id, *painting, rb_state_packer());
+		StateID id = insert_state(rb_initial_state_data);
+		cached_initial_state = new RBState(lookup_state(id));
 	}
 }
 
@@ -82,21 +99,15 @@ auto state_buffer_sanity_check(const PackedStateBin *buffer, const RBIntPacker &
 			if (!(int_packer.get(buffer, var) < g_root_task()->get_variable_domain_size(var)))
 				return false;
 		} else {
-			auto at_least_one_red = false;
-			for (auto val = 0; val < g_root_task()->get_variable_domain_size(var); ++val) {
-				if (int_packer.get_bit(buffer, var, val)) {
-					at_least_one_red = true;
-					break;
-				}
-			}
-			if (!at_least_one_red)
+			if (int_packer.count_red_values(buffer, var) == 0)
 				return false;
 		}
 	}
 	return true;
 }
 
-void RBStateRegistry::build_unsaturated_successor(const RBState &predecessor, const RBOperator &op, PackedStateBin *buffer) const {
+void RBStateRegistry::build_unsaturated_successor(const RBState &predecessor, const RBOperator &op, PackedStateBin *buffer,
+                                                  std::vector<FactPair> *new_facts) const {
 	auto effect_does_fire = [](const auto &effect, const auto &state) {
 		return std::all_of(std::begin(effect.conditions), std::end(effect.conditions), [&state](const auto &condition) {
 			return state.has_fact(condition.var, condition.val);
@@ -107,6 +118,8 @@ void RBStateRegistry::build_unsaturated_successor(const RBState &predecessor, co
 	for (const auto &effect : op.get_base_operator().get_effects()) {
 		if (effect_does_fire(effect, predecessor)) {
 			assert(effect.val < g_root_task()->get_variable_domain_size(effect.var));
+			if (new_facts && !predecessor.has_fact(effect.var, effect.val))
+				new_facts->emplace_back(effect.var, effect.val);
 			if (painting->is_black_var(effect.var)) {
 				rb_state_packer().set(buffer, effect.var, effect.val);
 				assert(rb_state_packer().get(buffer, effect.var) == effect.val);
@@ -123,14 +136,22 @@ auto RBStateRegistry::get_successor_state(const RBState &predecessor, const RBOp
 	assert(op.is_applicable(predecessor));
 	assert(!op.get_base_operator().is_axiom());
 	assert(op.is_black());
-	state_data_pool.push_back(predecessor.get_packed_buffer());
-	PackedStateBin *buffer = state_data_pool[state_data_pool.size() - 1];
-	build_unsaturated_successor(predecessor, op, buffer);
-	assert(state_buffer_sanity_check(buffer, rb_state_packer()));
-	auto supporters = state_saturation->saturate_state(buffer, get_best_supporters);
+	auto buffer = get_candidate_buffer(predecessor.get_packed_buffer());
+	auto supporters = std::vector<std::vector<OperatorID>>();
+	if (incremental_saturation && !get_best_supporters) {
+		// the predecessor is saturated already, so only the facts added by op can trigger new counters
+		successor_new_facts.clear();
+		build_unsaturated_successor(predecessor, op, buffer, &successor_new_facts);
+		assert(state_buffer_sanity_check(buffer, rb_state_packer()));
+		state_saturation->saturate_successor_state(buffer, successor_new_facts);
+	} else {
+		build_unsaturated_successor(predecessor, op, buffer);
+		assert(state_buffer_sanity_check(buffer, rb_state_packer()));
+		supporters = state_saturation->saturate_state(buffer, get_best_supporters);
+	}
 	assert(state_buffer_sanity_check(buffer, rb_state_packer()));
 	axiom_evaluator.evaluate(buffer, state_packer);
-	auto id = insert_id_or_pop_state();
+	auto id = insert_state(buffer, &predecessor);
 	assert(static_cast<int>(lookup_state(id).get_painting().get_painting().size()) == g_root_task()->get_num_variables());
 	return {lookup_state(id), supporters};
 }
@@ -145,16 +166,13 @@ auto RBStateRegistry::get_successor_state_and_best_supporters(const RBState &pre
 
 template<class ValuesType>
 auto RBStateRegistry::get_state(const ValuesType &values, bool get_best_supporters) -> std::pair<RBState, std::vector<std::vector<OperatorID>>> {
-	auto buffer = new PackedStateBin[get_bins_per_state()];
+	auto buffer = get_candidate_buffer();
 	populate_buffer(buffer, values);
 	assert(state_buffer_sanity_check(buffer, rb_state_packer()));
 	auto best_supporters = state_saturation->saturate_state(buffer, get_best_supporters);
 	assert(state_buffer_sanity_check(buffer, rb_state_packer()));
 	axiom_evaluator.evaluate(buffer, state_packer);
-	state_data_pool.push_back(buffer);
-	// buffer is copied by push_back
-	delete[] buffer;
-	StateID id = insert_id_or_pop_state();
+	StateID id = insert_state(buffer);
 	return {lookup_state(id), best_supporters};
 }
 
@@ -181,9 +199,7 @@ void RBStateRegistry::populate_buffer(PackedStateBin *buffer, const std::vector<
 	for (size_t i = 0; i < values.size(); ++i) {
 		assert(values[i].any());
 		if (painting->is_red_var(i)) {
-			rb_state_packer().init_zero(buffer, i);
-			for (auto pos = values[i].find_first(); pos != values[i].npos; pos = values[i].find_next(pos))
-				rb_state_packer().set_bit(buffer, i, pos);
+			rb_state_packer().set_red_values(buffer, i, values[i]);
 		} else {
 			assert(values[i].count() == 1);
 			rb_state_packer().set(buffer, i, values[i].find_first());
@@ -208,7 +224,7 @@ auto RBStateRegistry::get_state_and_best_supporters(const std::vector<boost::dyn
 }
 
 auto RBStateRegistry::lookup_state(StateID id) const -> RBState {
-	return RBState(state_data_pool[id.value], *this, id, *painting, rb_state_packer());
+	return RBState(get_state_data(id), *this, id);
 }
 
 auto RBStateRegistry::get_initial_state() -> const RBState & {
@@ -231,4 +247,23 @@ auto RBStateRegistry::get_best_supporters_for_successor(const RBState &predecess
 	return best_supporters;
 }
 
+void RBStateRegistry::generate_applicable_ops(const RBState &state, std::vector<OperatorID> &applicable_ops) {
+	if (!time_applicable_ops) {
+		successor_generator->generate_applicable_ops(state, applicable_ops);
+		return;
+	}
+	const auto timer = WallClockTimer();
+	successor_generator->generate_applicable_ops(state, applicable_ops);
+	applicable_ops_time += timer();
+}
+
+auto RBStateRegistry::estimate_painting_data_memory_usage() const -> std::size_t {
+	// the operators only refer to the tables of SharedTaskData
+	return utils::estimate_vector_bytes<RBOperator>(operators.size()) + state_saturation->estimate_memory_usage();
+}
+
+auto RBStateRegistry::estimate_state_memory_usage() const -> std::size_t {
+	return get_state_data_memory_usage() + registered_states.estimate_memory_usage();
+}
+
 }
@@ -14,6 +14,7 @@ namespace redblack {
 class RBState;
 class RBOperator;
 class StateSaturation;
+enum class StateSaturationType;
 
 class RBStateRegistry : public StateRegistryBase<RBState, RBOperator> {
 	const Painting *painting;
@@ -23,6 +24,7 @@ class RBStateRegistry : public StateRegistryBase<RBState, RBOperator> {
 	std::unique_ptr<std::vector<std::set<FactPair>>> last_traced_path_marked_facts;
 
 	friend class SearchSpace<RBState, RBOperator, StateRegistryBase<RBState, RBOperator>>;
+	friend class RBState;
 
 	void set_last_marked_facts(std::unique_ptr<std::vector<std::set<FactPair>>> last_traced_path_marked_facts) {
 		this->last_traced_path_marked_facts = std::move(last_traced_path_marked_facts);
@@ -32,11 +34,23 @@ class RBStateRegistry : public StateRegistryBase<RBState, RBOperator> {
 		return static_cast<const RBIntPacker &>(state_packer);
 	}
 
-	void build_unsaturated_successor(const RBState &predecessor, const RBOperator &op, PackedStateBin *buffer) const;
+	// if new_facts is given, it is filled with the facts of the successor that are not true in the predecessor
+	void build_unsaturated_successor(const RBState &predecessor, const RBOperator &op, PackedStateBin *buffer,
+	                                 std::vector<FactPair> *new_facts = nullptr) const;
 
 	std::unique_ptr<StateSaturation> state_saturation;
-
-	static auto get_state_saturation(const AbstractTask &task, const RBIntPacker &state_packer, const std::vector<RBOperator> &operators) -> std::unique_ptr<StateSaturation>;
+	// saturate successors starting from the (already saturated) predecessor instead of from scratch
+	const bool incremental_saturation;
+	std::vector<FactPair> successor_new_facts;
+
+	// successor generator that only switches on the black variables of this painting
+	const std::unique_ptr<successor_generator::SuccessorGenerator> successor_generator;
+	// only measured if time_applicable_ops is set, since it is called for every expansion
+	const bool time_applicable_ops;
+	double applicable_ops_time;
+
+	static auto get_state_saturation(const AbstractTask &task, const RBIntPacker &state_packer, const std::vector<RBOperator> &operators,
+	                                 StateSaturationType state_saturation_type) -> std::unique_ptr<StateSaturation>;
 	static auto construct_redblack_operators(const Painting &painting) -> std::vector<RBOperator>;
 
 	void populate_buffer(PackedStateBin *buffer, const std::vector<int> &values) const;
@@ -48,10 +62,12 @@ class RBStateRegistry : public StateRegistryBase<RBState, RBOperator> {
 public:
 	RBStateRegistry(const AbstractTask &task, const RBIntPacker &state_packer,
 	                AxiomEvaluator &axiom_evaluator, std::vector<int> &&initial_state_data,
-	                PackedStateBin *rb_initial_state_data = nullptr);
+	                StateSaturationType state_saturation_type, bool incremental_saturation = true,
+	                bool compress_states = false, bool time_applicable_ops = false, PackedStateBin *rb_initial_state_data = nullptr);
 	RBStateRegistry(const AbstractTask &task, const RBIntPacker &state_packer,
 	                AxiomEvaluator &axiom_evaluator, const std::vector<int> &initial_state_data,
-	                PackedStateBin *rb_initial_state_data = nullptr);
+	                StateSaturationType state_saturation_type, bool incremental_saturation = true,
+	                bool compress_states = false, bool time_applicable_ops = false, PackedStateBin *rb_initial_state_data = nullptr);
 	~RBStateRegistry();
 
 	auto get_initial_state_best_supporters() const -> const std::vector<std::vector<OperatorID>> & {
@@ -65,6 +81,7 @@ public:
 	auto lookup_state(StateID id) const -> RBState override;
 	auto get_initial_state() -> const RBState & override;
 	auto get_successor_state(const RBState &predecessor, const RBOperator &op) -> RBState override;
+	void generate_applicable_ops(const RBState &state, std::vector<OperatorID> &applicable_ops) override;
 	auto get_successor_state_and_best_supporters(const RBState &predecessor, const RBOperator &op) -> std::pair<RBState, std::vector<std::vector<OperatorID>>>;
 	auto get_best_supporters_for_successor(const RBState &predecessor, const RBOperator &op) const -> std::vector<std::vector<OperatorID>>;
 	auto get_state(const std::vector<int> &values) -> RBState;
@@ -75,6 +92,14 @@ public:
 	auto get_painting() const -> const Painting & { return *painting; }
 
 	auto get_operators() const -> const std::vector<RBOperator> & { return operators; }
+
+	// wall-clock time spent generating applicable operators in states of this registry (0 unless time_applicable_ops is set)
+	auto get_applicable_ops_time() const -> double { return applicable_ops_time; }
+
+	// memory used by the painting-specific operators and state saturation (excluding the stored states)
+	auto estimate_painting_data_memory_usage() const -> std::size_t;
+	// memory used by the stored states and the hash set of registered states
+	auto estimate_state_memory_usage() const -> std::size_t;
 };
 
 }
@@ -1,21 +1,42 @@
 #include "state_saturation.h"
 
 #include "operator.h"
+#include "shared_task_data.h"
 #include "../globals.h"
+#include "../utils/collections.h"
+#include "../utils/language.h"
 #ifndef NDEBUG
 #include "util.h"
 #endif
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <map>
 
 namespace redblack {
 
+// sorts the effect preconditions and merges them with the sorted preconditions of an operator into result
+void merge_sorted_preconditions(const std::vector<FactPair> &operator_preconditions, std::vector<FactPair> &effect_preconditions,
+                                std::vector<FactPair> &result) {
+	std::sort(std::begin(effect_preconditions), std::end(effect_preconditions));
+	result.clear();
+	std::merge(std::begin(operator_preconditions), std::end(operator_preconditions),
+	           std::begin(effect_preconditions), std::end(effect_preconditions), std::back_inserter(result));
+}
+
 StateSaturation::StateSaturation(const AbstractTask &task, const RBIntPacker &state_packer, const std::vector<RBOperator> &operators)
 	: task(task), state_packer(state_packer), operators(operators) {}
 
 template<>
 CounterBasedStateSaturation<false>::CounterBasedStateSaturation(const AbstractTask &task, const RBIntPacker &state_packer, const std::vector<RBOperator> &operators)
-	: StateSaturation(task, state_packer, operators), counters(), precondition_of(task.get_num_variables()) {
+	: StateSaturation(task, state_packer, operators),
+	  counters(),
+	  precondition_of(task.get_num_variables()),
+	  black_condition_of(),
+	  open_facts(),
+	  triggered_in_pass(),
+	  current_pass(0) {
 	// initialize counters
 	assert(!any_conditional_effect_condition_is_red(state_packer.get_painting()));
 	auto counter_for_preconditions = std::unordered_map<std::vector<FactPair>, std::size_t>();
@@ -24,7 +45,7 @@ CounterBasedStateSaturation<false>::CounterBasedStateSaturation(const AbstractTa
 		if (inserted) {
 			for (const auto &precondition : preconditions)
 				precondition_of[precondition.var][precondition.value].push_back(counters.size());
-			counters.emplace_back(preconditions.size());
+			counters.emplace_back(preconditions);
 		}
 		return pos->second;
 	};
@@ -33,6 +54,9 @@ CounterBasedStateSaturation<false>::CounterBasedStateSaturation(const AbstractTa
 	};
 	for (auto var = 0; var < task.get_num_variables(); ++var)
 		precondition_of[var].resize(task.get_variable_domain_size(var));
+	// scratch space for the operators whose black effects become preconditions
+	auto effect_preconditions = std::vector<FactPair>();
+	auto merged_preconditions = std::vector<FactPair>();
 	for (const auto &op : operators) {
 		if (op.get_red_effects().empty())
 			continue;
@@ -41,11 +65,8 @@ CounterBasedStateSaturation<false>::CounterBasedStateSaturation(const AbstractTa
 		// b) conditionally modifies black variables ==> fine if the effect does nothing in the current state (add precondition)
 		// c) always modifies black variables ==> ignore this operator
 		auto changes_black_variable = false;
-		auto preconditions = std::vector<FactPair>();
-		for (const auto &precondition : op.get_base_operator().get_preconditions())
-			preconditions.emplace_back(precondition.var, precondition.val);
-		std::sort(std::begin(preconditions), std::end(preconditions));
-		auto black_conditional_effects_preconditions = std::vector<std::pair<FactPair, std::vector<FactPair>>>();
+		const auto &operator_preconditions = SharedTaskData::get().get_sorted_preconditions(op.get_id().get_index());
+		effect_preconditions.clear();
 		for (const auto effect : op.get_black_effects()) {
 			assert(std::none_of(std::begin(op.get_black_preconditions()), std::end(op.get_black_preconditions()), [effect](const auto precondition) {
 				return precondition->var == effect->var && precondition->val == effect->val;
@@ -60,14 +81,15 @@ CounterBasedStateSaturation<false>::CounterBasedStateSaturation(const AbstractTa
 				break;
 			} else {
 				// the variable may not change if the effect is already contained in the state
-				preconditions.emplace_back(effect->var, effect->val);
+				effect_preconditions.emplace_back(effect->var, effect->val);
 			}
 		}
 		if (changes_black_variable)
 			continue;
-		std::sort(std::begin(preconditions) + op.get_base_operator().get_preconditions().size(), std::end(preconditions));
-		std::inplace_merge(std::begin(preconditions), std::begin(preconditions) + op.get_base_operator().get_preconditions().size(), std::end(preconditions));
-		assert(std::unique(std::begin(preconditions), std::end(preconditions)) == std::end(preconditions));
+		if (!effect_preconditions.empty())
+			merge_sorted_preconditions(operator_preconditions, effect_preconditions, merged_preconditions);
+		const auto &preconditions = effect_preconditions.empty() ? operator_preconditions : merged_preconditions;
+		assert(std::adjacent_find(std::begin(preconditions), std::end(preconditions)) == std::end(preconditions));
 
 		auto &counter = counters[get_counter_pos_for_preconditions(preconditions)];
 		for (const auto effect : op.get_red_effects()) {
@@ -79,6 +101,7 @@ CounterBasedStateSaturation<false>::CounterBasedStateSaturation(const AbstractTa
 	for (auto var = 0; var < task.get_num_variables(); ++var)
 		for (auto val = 0; val < task.get_variable_domain_size(var); ++val)
 			precondition_of[var][val].shrink_to_fit();
+	triggered_in_pass.assign(counters.size(), 0);
 }
 
 auto contains_mutex(const std::vector<FactPair> &facts) -> bool {
@@ -157,7 +180,13 @@ auto simplify_condeff_preconditions(std::vector<FactPair> preconditions,
 
 template<>
 CounterBasedStateSaturation<true>::CounterBasedStateSaturation(const AbstractTask &task, const RBIntPacker &state_packer, const std::vector<RBOperator> &operators)
-	: StateSaturation(task, state_packer, operators), counters(), precondition_of(task.get_num_variables()) {
+	: StateSaturation(task, state_packer, operators),
+	  counters(),
+	  precondition_of(task.get_num_variables()),
+	  black_condition_of(),
+	  open_facts(),
+	  triggered_in_pass(),
+	  current_pass(0) {
 	// initialize counters
 	assert(!any_conditional_effect_condition_is_red(state_packer.get_painting()));
 	auto counter_for_preconditions = std::map<std::tuple<std::vector<FactPair>, std::vector<std::vector<FactPair>>, std::vector<std::pair<FactPair, std::vector<FactPair>>>>, std::size_t>();
@@ -166,7 +195,7 @@ CounterBasedStateSaturation<true>::CounterBasedStateSaturation(const AbstractTas
 		if (inserted) {
 			for (const auto &precondition : preconditions)
 				precondition_of[precondition.var][precondition.value].push_back(counters.size());
-			counters.emplace_back(preconditions.size(), negative_preconditions, condeff_preconditions);
+			counters.emplace_back(preconditions, negative_preconditions, condeff_preconditions);
 		}
 		return pos->second;
 	};
@@ -175,6 +204,9 @@ CounterBasedStateSaturation<true>::CounterBasedStateSaturation(const AbstractTas
 	};
 	for (auto var = 0; var < task.get_num_variables(); ++var)
 		precondition_of[var].resize(task.get_variable_domain_size(var));
+	// scratch space for the operators whose black effects become preconditions
+	auto effect_preconditions = std::vector<FactPair>();
+	auto preconditions = std::vector<FactPair>();
 	for (const auto &op : operators) {
 		if (op.get_red_effects().empty())
 			continue;
@@ -183,9 +215,7 @@ CounterBasedStateSaturation<true>::CounterBasedStateSaturation(const AbstractTas
 		// b) conditionally modifies black variables ==> need negative preconditions that prevent these conditional effects from triggering, or the effect does nothing in the current state (add precondition)
 		// c) always modifies black variables ==> ignore this operator
 		auto changes_black_variable = false;
-		auto preconditions = std::vector<FactPair>();
-		for (const auto &precondition : op.get_base_operator().get_preconditions())
-			preconditions.emplace_back(precondition.var, precondition.val);
+		effect_preconditions.clear();
 		auto negative_preconditions = std::vector<std::vector<FactPair>>();
 		auto condeff_preconditions = std::vector<std::pair<FactPair, std::vector<FactPair>>>();
 		for (const auto effect : op.get_black_effects()) {
@@ -205,7 +235,7 @@ CounterBasedStateSaturation<true>::CounterBasedStateSaturation(const AbstractTas
 					break;
 				} else {
 					// the variable may not change if the effect is already contained in the state
-					preconditions.emplace_back(effect->var, effect->val);
+					effect_preconditions.emplace_back(effect->var, effect->val);
 				}
 			} else {
 				auto conditions = std::vector<FactPair>();
@@ -227,7 +257,7 @@ CounterBasedStateSaturation<true>::CounterBasedStateSaturation(const AbstractTas
 		}
 		if (changes_black_variable)
 			continue;
-		std::sort(std::begin(preconditions), std::end(preconditions));
+		merge_sorted_preconditions(SharedTaskData::get().get_sorted_preconditions(op.get_id().get_index()), effect_preconditions, preconditions);
 		assert(std::unique(std::begin(preconditions), std::end(preconditions)) == std::end(preconditions));
 
 		if (!negative_preconditions.empty() || !condeff_preconditions.empty()) {
@@ -268,6 +298,55 @@ CounterBasedStateSaturation<true>::CounterBasedStateSaturation(const AbstractTas
 	for (auto var = 0; var < task.get_num_variables(); ++var)
 		for (auto val = 0; val < task.get_variable_domain_size(var); ++val)
 			precondition_of[var][val].shrink_to_fit();
+	// index the counters by the black variables of their conditional effect conditions,
+	// these need to be reconsidered when the value of such a variable changes
+	black_condition_of.resize(task.get_num_variables());
+	for (auto counter_pos = 0u; counter_pos < counters.size(); ++counter_pos) {
+		auto condition_vars = std::vector<int>();
+		for (const auto &negative_disjunctive_precondition : counters[counter_pos].negative_preconditions)
+			for (const auto &precondition : negative_disjunctive_precondition)
+				condition_vars.push_back(precondition.var);
+		for (const auto &condeff_precondition : counters[counter_pos].condeff_preconditions) {
+			condition_vars.push_back(condeff_precondition.first.var);
+			for (const auto &precondition : condeff_precondition.second)
+				condition_vars.push_back(precondition.var);
+		}
+		std::sort(std::begin(condition_vars), std::end(condition_vars));
+		condition_vars.erase(std::unique(std::begin(condition_vars), std::end(condition_vars)), std::end(condition_vars));
+		for (const auto var : condition_vars)
+			black_condition_of[var].push_back(counter_pos);
+	}
+	triggered_in_pass.assign(counters.size(), 0);
+}
+
+template<bool support_conditional_effects>
+auto CounterBasedStateSaturation<support_conditional_effects>::has_fact(const PackedStateBin *buffer, const FactPair &fact) const -> bool {
+	return state_packer.get_painting().is_black_var(fact.var) ?
+		state_packer.get(buffer, fact.var) == fact.value :
+		state_packer.get_bit(buffer, fact.var, fact.value);
+}
+
+template<bool support_conditional_effects>
+auto CounterBasedStateSaturation<support_conditional_effects>::is_blocked_by_black_effects(const CounterType &counter, const PackedStateBin *buffer) const -> bool {
+	if constexpr(support_conditional_effects) {
+		return !std::all_of(std::begin(counter.negative_preconditions), std::end(counter.negative_preconditions), [this, buffer](const auto &negative_disjunctive_precondition) {
+			return std::any_of(std::begin(negative_disjunctive_precondition), std::end(negative_disjunctive_precondition), [this, buffer](const auto &precondition) {
+				assert(state_packer.get_painting().is_black_var(precondition.var));
+				return state_packer.get(buffer, precondition.var) != precondition.value;
+			});
+		}) || !std::all_of(std::begin(counter.condeff_preconditions), std::end(counter.condeff_preconditions), [this, buffer](const auto &condeff_precondition) {
+			assert(state_packer.get_painting().is_black_var(condeff_precondition.first.var));
+			return state_packer.get(buffer, condeff_precondition.first.var) == condeff_precondition.first.value
+				|| std::any_of(std::begin(condeff_precondition.second), std::end(condeff_precondition.second), [this, buffer](const auto &precondition) {
+				assert(state_packer.get_painting().is_black_var(precondition.var));
+				return state_packer.get(buffer, precondition.var) != precondition.value;
+			});
+		});
+	} else {
+		utils::unused_variable(counter);
+		utils::unused_variable(buffer);
+		return false;
+	}
 }
 
 template<bool support_conditional_effects>
@@ -288,23 +367,9 @@ auto CounterBasedStateSaturation<support_conditional_effects>::saturate_state(Pa
 	// reset counter values
 	for (auto &counter : counters) {
 		counter.value = counter.num_preconditions;
-		if constexpr(support_conditional_effects) {
-			if (!std::all_of(std::begin(counter.negative_preconditions), std::end(counter.negative_preconditions), [this, buffer](const auto &negative_disjunctive_precondition) {
-				return std::any_of(std::begin(negative_disjunctive_precondition), std::end(negative_disjunctive_precondition), [this, buffer](const auto &precondition) {
-					assert(state_packer.get_painting().is_black_var(precondition.var));
-					return state_packer.get(buffer, precondition.var) != precondition.value;
-				});
-			}) || !std::all_of(std::begin(counter.condeff_preconditions), std::end(counter.condeff_preconditions), [this, buffer](const auto &condeff_precondition) {
-				assert(state_packer.get_painting().is_black_var(condeff_precondition.first.var));
-				return state_packer.get(buffer, condeff_precondition.first.var) == condeff_precondition.first.value
-					|| std::any_of(std::begin(condeff_precondition.second), std::end(condeff_precondition.second), [this, buffer](const auto &precondition) {
-					assert(state_packer.get_painting().is_black_var(precondition.var));
-					return state_packer.get(buffer, precondition.var) != precondition.value;
-				});
-			}))
-				// black conditional effects will change black variables, make counter unreachable
-				++counter.value;
-		}
+		if (is_blocked_by_black_effects(counter, buffer))
+			// black conditional effects will change black variables, make counter unreachable
+			++counter.value;
 		if (counter.value == 0)
 			triggered.push_back(&counter);
 	}
@@ -362,4 +427,282 @@ auto CounterBasedStateSaturation<support_conditional_effects>::saturate_state(Pa
 	return best_supporters;
 }
 
+template<bool support_conditional_effects>
+void CounterBasedStateSaturation<support_conditional_effects>::saturate_successor_state(PackedStateBin *buffer, const std::vector<FactPair> &new_facts) {
+	if (counters.empty())
+		return;
+
+	// all counters that are satisfied without any of the new facts already
+	// triggered in the predecessor, so we only need to look at the counters
+	// that depend on one of the new facts
+	if (++current_pass == 0) {
+		std::fill(std::begin(triggered_in_pass), std::end(triggered_in_pass), 0);
+		current_pass = 1;
+	}
+	auto try_trigger = [this, buffer](std::size_t counter_pos) {
+		if (triggered_in_pass[counter_pos] == current_pass)
+			return;
+		const auto &counter = counters[counter_pos];
+		if (!std::all_of(std::begin(counter.preconditions), std::end(counter.preconditions), [this, buffer](const auto &precondition) {
+			return has_fact(buffer, precondition);
+		}) || is_blocked_by_black_effects(counter, buffer))
+			return;
+		triggered_in_pass[counter_pos] = current_pass;
+		for (const auto &effect : counter.effects) {
+			assert(state_packer.get_painting().is_red_var(effect.fact.var));
+			if (!state_packer.get_bit(buffer, effect.fact.var, effect.fact.value)) {
+				state_packer.set_bit(buffer, effect.fact.var, effect.fact.value);
+				open_facts.push_back(effect.fact);
+			}
+		}
+	};
+
+	open_facts.assign(std::begin(new_facts), std::end(new_facts));
+	for (std::size_t i = 0; i < open_facts.size(); ++i) {
+		const auto fact = open_facts[i];
+		assert(has_fact(buffer, fact));
+		if constexpr(support_conditional_effects) {
+			if (state_packer.get_painting().is_black_var(fact.var))
+				for (const auto counter_pos : black_condition_of[fact.var])
+					try_trigger(counter_pos);
+		}
+		for (const auto counter_pos : precondition_of[fact.var][fact.value])
+			try_trigger(counter_pos);
+	}
+}
+
+template<bool support_conditional_effects>
+auto CounterBasedStateSaturation<support_conditional_effects>::estimate_memory_usage() const -> std::size_t {
+	auto bytes = utils::estimate_vector_bytes<CounterType>(counters.size());
+	for (const auto &counter : counters) {
+		bytes += utils::estimate_vector_bytes<detail::Counter::Effect>(counter.effects.size());
+		bytes += utils::estimate_vector_bytes<FactPair>(counter.preconditions.size());
+		if constexpr(support_conditional_effects) {
+			for (const auto &negative_disjunctive_precondition : counter.negative_preconditions)
+				bytes += utils::estimate_vector_bytes<FactPair>(negative_disjunctive_precondition.size());
+			for (const auto &condeff_precondition : counter.condeff_preconditions)
+				bytes += sizeof(FactPair) + utils::estimate_vector_bytes<FactPair>(condeff_precondition.second.size());
+		}
+	}
+	for (const auto &precondition_of_var : precondition_of)
+		for (const auto &precondition_of_fact : precondition_of_var)
+			bytes += utils::estimate_vector_bytes<std::size_t>(precondition_of_fact.size());
+	for (const auto &black_condition_of_var : black_condition_of)
+		bytes += utils::estimate_vector_bytes<std::size_t>(black_condition_of_var.size());
+	return bytes + utils::estimate_vector_bytes<unsigned int>(triggered_in_pass.size());
+}
+
+template<bool support_conditional_effects>
+FlatCounterStateSaturation<support_conditional_effects>::FlatCounterStateSaturation(const AbstractTask &task, const RBIntPacker &state_packer, const std::vector<RBOperator> &operators)
+	: CounterBasedStateSaturation<support_conditional_effects>(task, state_packer, operators),
+	  shared_task_data(SharedTaskData::get()),
+	  num_counters(this->counters.size()),
+	  initial_values(),
+	  values(num_counters),
+	  effect_begin(),
+	  effect_facts(),
+	  effect_supporters(),
+	  precondition_begin(),
+	  counter_preconditions(),
+	  precondition_of_begin(),
+	  precondition_of_counters(),
+	  unconditional_counters(),
+	  guarded_counters(),
+	  guard_of(),
+	  triggered() {
+	assert(num_counters < std::numeric_limits<CounterIndex>::max());
+	auto &counters = this->counters;
+	auto &precondition_of = this->precondition_of;
+
+	// compile the counters
+	initial_values.reserve(num_counters);
+	effect_begin.reserve(num_counters + 1);
+	precondition_begin.reserve(num_counters + 1);
+	for (std::size_t counter_pos = 0; counter_pos < num_counters; ++counter_pos) {
+		const auto &counter = counters[counter_pos];
+		initial_values.push_back(counter.num_preconditions);
+		if (counter.num_preconditions == 0)
+			unconditional_counters.push_back(counter_pos);
+		effect_begin.push_back(effect_facts.size());
+		for (const auto &effect : counter.effects) {
+			effect_facts.push_back(effect.fact);
+			effect_supporters.push_back(effect.supporter);
+		}
+		precondition_begin.push_back(counter_preconditions.size());
+		counter_preconditions.insert(std::end(counter_preconditions), std::begin(counter.preconditions), std::end(counter.preconditions));
+	}
+	effect_begin.push_back(effect_facts.size());
+	precondition_begin.push_back(counter_preconditions.size());
+
+	// compile the fact-to-counter index
+	precondition_of_begin.reserve(shared_task_data.get_num_facts() + 1);
+	for (auto var = 0; var < task.get_num_variables(); ++var) {
+		for (auto val = 0; val < task.get_variable_domain_size(var); ++val) {
+			assert(precondition_of_begin.size() == get_fact_index(var, val));
+			precondition_of_begin.push_back(precondition_of_counters.size());
+			precondition_of_counters.insert(std::end(precondition_of_counters), std::begin(precondition_of[var][val]), std::end(precondition_of[var][val]));
+		}
+	}
+	precondition_of_begin.push_back(precondition_of_counters.size());
+
+	// only keep the original counters that are needed to check black conditional effect conditions
+	if constexpr(support_conditional_effects) {
+		guard_of.assign(num_counters, NO_GUARD);
+		auto guards = std::vector<typename CounterBasedStateSaturation<support_conditional_effects>::CounterType>();
+		for (std::size_t counter_pos = 0; counter_pos < num_counters; ++counter_pos) {
+			if (!counters[counter_pos].negative_preconditions.empty() || !counters[counter_pos].condeff_preconditions.empty()) {
+				guard_of[counter_pos] = guards.size();
+				guarded_counters.push_back(counter_pos);
+				guards.push_back(counters[counter_pos]);
+			}
+		}
+		counters = std::move(guards);
+	} else {
+		counters.clear();
+	}
+	counters.shrink_to_fit();
+	precondition_of.clear();
+	precondition_of.shrink_to_fit();
+}
+
+template<bool support_conditional_effects>
+auto FlatCounterStateSaturation<support_conditional_effects>::is_blocked(CounterIndex counter, const PackedStateBin *buffer) const -> bool {
+	if constexpr(support_conditional_effects) {
+		return guard_of[counter] != NO_GUARD && this->is_blocked_by_black_effects(this->counters[guard_of[counter]], buffer);
+	} else {
+		utils::unused_variable(counter);
+		utils::unused_variable(buffer);
+		return false;
+	}
+}
+
+template<bool support_conditional_effects>
+void FlatCounterStateSaturation<support_conditional_effects>::decrement_counters(std::size_t fact_index) {
+	const auto end = precondition_of_begin[fact_index + 1];
+	for (auto i = precondition_of_begin[fact_index]; i < end; ++i) {
+		const auto counter = precondition_of_counters[i];
+		if (--values[counter] == 0)
+			triggered.push_back(counter);
+	}
+}
+
+template<bool support_conditional_effects>
+auto FlatCounterStateSaturation<support_conditional_effects>::saturate_state(PackedStateBin *buffer, bool store_best_supporters) -> std::vector<std::vector<OperatorID>> {
+	const auto &task = this->task;
+	const auto &state_packer = this->state_packer;
+	auto best_supporters = std::vector<std::vector<OperatorID>>();
+	if (store_best_supporters) {
+		best_supporters.resize(task.get_num_variables());
+		for (auto var = 0; var < task.get_num_variables(); ++var)
+			best_supporters[var].assign(task.get_variable_domain_size(var), OperatorID(-1));
+	}
+
+	if (num_counters == 0)
+		return best_supporters;
+
+	// reset counter values, counters that are blocked by black conditional effects are made unreachable
+	std::copy(std::begin(initial_values), std::end(initial_values), std::begin(values));
+	for (const auto counter : guarded_counters)
+		if (is_blocked(counter, buffer))
+			++values[counter];
+	triggered.clear();
+	for (const auto counter : unconditional_counters)
+		if (values[counter] == 0)
+			triggered.push_back(counter);
+
+	for (auto var = 0; var < task.get_num_variables(); ++var) {
+		if (state_packer.get_painting().is_black_var(var)) {
+			decrement_counters(get_fact_index(var, state_packer.get(buffer, var)));
+		} else {
+			for (auto val = 0; val < task.get_variable_domain_size(var); ++val) {
+				if (state_packer.get_bit(buffer, var, val))
+					decrement_counters(get_fact_index(var, val));
+			}
+		}
+	}
+
+	// triggered is processed in FIFO order, which is the same order as the layers in CounterBasedStateSaturation
+	for (std::size_t i = 0; i < triggered.size(); ++i) {
+		const auto counter = triggered[i];
+		assert(values[counter] == 0);
+		for (auto effect = effect_begin[counter]; effect < effect_begin[counter + 1]; ++effect) {
+			const auto &fact = effect_facts[effect];
+			assert(state_packer.get_painting().is_red_var(fact.var));
+			if (!state_packer.get_bit(buffer, fact.var, fact.value)) {
+				state_packer.set_bit(buffer, fact.var, fact.value);
+				if (store_best_supporters)
+					best_supporters[fact.var][fact.value] = effect_supporters[effect];
+				decrement_counters(get_fact_index(fact.var, fact.value));
+			}
+		}
+	}
+
+	return best_supporters;
+}
+
+template<bool support_conditional_effects>
+void FlatCounterStateSaturation<support_conditional_effects>::saturate_successor_state(PackedStateBin *buffer, const std::vector<FactPair> &new_facts) {
+	if (num_counters == 0)
+		return;
+
+	auto &open_facts = this->open_facts;
+	auto &triggered_in_pass = this->triggered_in_pass;
+	auto &current_pass = this->current_pass;
+	if (++current_pass == 0) {
+		std::fill(std::begin(triggered_in_pass), std::end(triggered_in_pass), 0);
+		current_pass = 1;
+	}
+	auto try_trigger = [this, buffer, &open_facts, &triggered_in_pass, &current_pass](CounterIndex counter) {
+		if (triggered_in_pass[counter] == current_pass)
+			return;
+		for (auto precondition = precondition_begin[counter]; precondition < precondition_begin[counter + 1]; ++precondition)
+			if (!this->has_fact(buffer, counter_preconditions[precondition]))
+				return;
+		if (is_blocked(counter, buffer))
+			return;
+		triggered_in_pass[counter] = current_pass;
+		for (auto effect = effect_begin[counter]; effect < effect_begin[counter + 1]; ++effect) {
+			const auto &fact = effect_facts[effect];
+			assert(this->state_packer.get_painting().is_red_var(fact.var));
+			if (!this->state_packer.get_bit(buffer, fact.var, fact.value)) {
+				this->state_packer.set_bit(buffer, fact.var, fact.value);
+				open_facts.push_back(fact);
+			}
+		}
+	};
+
+	open_facts.assign(std::begin(new_facts), std::end(new_facts));
+	for (std::size_t i = 0; i < open_facts.size(); ++i) {
+		const auto fact = open_facts[i];
+		assert(this->has_fact(buffer, fact));
+		if constexpr(support_conditional_effects) {
+			if (this->state_packer.get_painting().is_black_var(fact.var))
+				for (const auto counter : this->black_condition_of[fact.var])
+					try_trigger(counter);
+		}
+		const auto fact_index = get_fact_index(fact.var, fact.value);
+		for (auto pos = precondition_of_begin[fact_index]; pos < precondition_of_begin[fact_index + 1]; ++pos)
+			try_trigger(precondition_of_counters[pos]);
+	}
+}
+
+template<bool support_conditional_effects>
+auto FlatCounterStateSaturation<support_conditional_effects>::estimate_memory_usage() const -> std::size_t {
+	return CounterBasedStateSaturation<support_conditional_effects>::estimate_memory_usage()
+		+ 2 * utils::estimate_vector_bytes<int>(num_counters)
+		+ utils::estimate_vector_bytes<CounterIndex>(effect_begin.size())
+		+ utils::estimate_vector_bytes<FactPair>(effect_facts.size())
+		+ utils::estimate_vector_bytes<OperatorID>(effect_supporters.size())
+		+ utils::estimate_vector_bytes<CounterIndex>(precondition_begin.size())
+		+ utils::estimate_vector_bytes<FactPair>(counter_preconditions.size())
+		+ utils::estimate_vector_bytes<std::size_t>(precondition_of_begin.size())
+		+ utils::estimate_vector_bytes<CounterIndex>(precondition_of_counters.size())
+		+ utils::estimate_vector_bytes<CounterIndex>(unconditional_counters.size())
+		+ utils::estimate_vector_bytes<CounterIndex>(guarded_counters.size())
+		+ utils::estimate_vector_bytes<int>(guard_of.size());
+}
+
+template class FlatCounterStateSaturation<false>;
+template class FlatCounterStateSaturation<true>;
+
 }
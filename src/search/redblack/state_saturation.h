@@ -1,16 +1,23 @@
 #ifndef REDBLACK_STATE_SATURATION_H
 #define REDBLACK_STATE_SATURATION_H
 
+#include "shared_task_data.h"
 #include "state.h"
 #include "../operator_id.h"
 #include <vector>
 
 namespace redblack {
+enum class StateSaturationType {
+	COUNTERS,
+	FLAT_COUNTERS
+};
+
 namespace detail {
 struct Counter {
-	Counter(int num_preconditions) :
+	Counter(const std::vector<FactPair> &preconditions) :
 		effects(),
-		num_preconditions(num_preconditions),
+		preconditions(preconditions),
+		num_preconditions(preconditions.size()),
 		value(0) {}
 
 	struct Effect {
@@ -22,15 +29,16 @@ struct Counter {
 	};
 
 	std::vector<Effect> effects;
+	const std::vector<FactPair> preconditions;
 	const int num_preconditions;
 	int value;
 };
 
 struct CondEffCounter : Counter {
-	CondEffCounter(int num_preconditions,
+	CondEffCounter(const std::vector<FactPair> &preconditions,
 	               const std::vector<std::vector<FactPair>> &negative_preconditions,
 	               const std::vector<std::pair<FactPair, std::vector<FactPair>>> &condeff_preconditions) :
-		Counter(num_preconditions),
+		Counter(preconditions),
 		negative_preconditions(negative_preconditions),
 		condeff_preconditions(condeff_preconditions) {}
 
@@ -46,6 +54,17 @@ public:
 
 	virtual auto saturate_state(PackedStateBin *buffer, bool store_best_supporters = false) -> std::vector<std::vector<OperatorID>> = 0;
 
+	/*
+	  Saturates the successor of a state that is already saturated. The buffer
+	  must contain the data of the saturated predecessor with the effects of
+	  the applied operator, and new_facts must contain exactly the facts that
+	  are true in the buffer but were not true in the predecessor. Only the
+	  consequences of these facts are propagated.
+	*/
+	virtual void saturate_successor_state(PackedStateBin *buffer, const std::vector<FactPair> &new_facts) = 0;
+
+	virtual auto estimate_memory_usage() const -> std::size_t = 0;
+
 protected:
 	const AbstractTask &task;
 	const RBIntPacker &state_packer;
@@ -59,12 +78,76 @@ public:
 	~CounterBasedStateSaturation() = default;
 
 	auto saturate_state(PackedStateBin *buffer, bool store_best_supporters) -> std::vector<std::vector<OperatorID>> override;
+	void saturate_successor_state(PackedStateBin *buffer, const std::vector<FactPair> &new_facts) override;
+	auto estimate_memory_usage() const -> std::size_t override;
 
 protected:
 	using CounterType = std::conditional_t<support_conditional_effects, detail::CondEffCounter, detail::Counter>;
 
+	auto has_fact(const PackedStateBin *buffer, const FactPair &fact) const -> bool;
+	auto is_blocked_by_black_effects(const CounterType &counter, const PackedStateBin *buffer) const -> bool;
+
 	std::vector<CounterType> counters;
 	std::vector<std::vector<std::vector<std::size_t>>> precondition_of;
+	// counters with black conditional effect conditions on the variable (only used with conditional effects)
+	std::vector<std::vector<std::size_t>> black_condition_of;
+
+	// scratch space for the incremental saturation
+	std::vector<FactPair> open_facts;
+	std::vector<unsigned int> triggered_in_pass;
+	unsigned int current_pass;
+};
+
+/*
+  Same counters as CounterBasedStateSaturation, but compiled into contiguous
+  arrays (CSR layout) after construction: the counter values, the effects and
+  the preconditions of all counters as well as the fact-to-counter index are
+  each stored in a single vector with offsets. Only the counters with black
+  conditional effect conditions keep their original representation.
+*/
+template<bool support_conditional_effects>
+class FlatCounterStateSaturation : public CounterBasedStateSaturation<support_conditional_effects> {
+public:
+	FlatCounterStateSaturation(const AbstractTask &task, const RBIntPacker &state_packer, const std::vector<RBOperator> &operators);
+	~FlatCounterStateSaturation() = default;
+
+	auto saturate_state(PackedStateBin *buffer, bool store_best_supporters) -> std::vector<std::vector<OperatorID>> override;
+	void saturate_successor_state(PackedStateBin *buffer, const std::vector<FactPair> &new_facts) override;
+	auto estimate_memory_usage() const -> std::size_t override;
+
+private:
+	using CounterIndex = unsigned int;
+	static constexpr int NO_GUARD = -1;
+
+	auto get_fact_index(int var, int val) const -> std::size_t {
+		return shared_task_data.get_fact_index(var, val);
+	}
+	auto is_blocked(CounterIndex counter, const PackedStateBin *buffer) const -> bool;
+	void decrement_counters(std::size_t fact_index);
+
+	const SharedTaskData &shared_task_data;
+	std::size_t num_counters;
+	// number of preconditions of each counter (value the counters are reset to)
+	std::vector<int> initial_values;
+	std::vector<int> values;
+	// effects of counter i are in [effect_begin[i], effect_begin[i + 1])
+	std::vector<CounterIndex> effect_begin;
+	std::vector<FactPair> effect_facts;
+	std::vector<OperatorID> effect_supporters;
+	// preconditions of counter i are in [precondition_begin[i], precondition_begin[i + 1])
+	std::vector<CounterIndex> precondition_begin;
+	std::vector<FactPair> counter_preconditions;
+	// counters with precondition fact f are in [precondition_of_begin[f], precondition_of_begin[f + 1])
+	std::vector<std::size_t> precondition_of_begin;
+	std::vector<CounterIndex> precondition_of_counters;
+	// counters without preconditions, these are triggered initially unless they are blocked
+	std::vector<CounterIndex> unconditional_counters;
+	// counters with black conditional effect conditions (only used with conditional effects), the
+	// original representation of counter i is kept in this->counters at position guard_of[i]
+	std::vector<CounterIndex> guarded_counters;
+	std::vector<int> guard_of;
+
+	std::vector<CounterIndex> triggered;
 };
 }
 
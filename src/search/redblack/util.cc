@@ -1,12 +1,19 @@
 #include "util.h"
 
 #include "operator.h"
+#include "rb_data.h"
+#include "state.h"
+#include "state_saturation.h"
 #include "../operator_cost.h"
 #include "../options/bounds.h"
 #include "../options/option_parser.h"
 #include "../globals.h"
 #include "mercury/red_black_DAG_fact_following_heuristic.h"
 
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
 auto get_adjusted_action_cost(const redblack::RBOperator &op, OperatorCost cost_type) -> int {
 	return get_adjusted_action_cost(op.get_base_operator(), cost_type);
 }
@@ -51,6 +58,21 @@ auto get_num_black(const options::Options &opts, bool min_one_if_ratio) -> int {
 	return std::min(num_variables, opts.get<int>("num_black"));
 }
 
+void add_state_saturation_options(options::OptionParser &parser) {
+	parser.add_enum_option("state_saturation", {"COUNTERS", "FLAT_COUNTERS"},
+		"data layout of the counters used to saturate the red variables of red-black states", "COUNTERS",
+		{"one counter object per precondition set with its own effect vector",
+		 "counters, effects and the fact-to-counter index in contiguous arrays"});
+	parser.add_option<bool>("incremental_saturation", "saturate red-black successor states starting from the saturated predecessor state "
+		"(falls back to saturating from scratch if best supporters are required or the task has axioms)", "true");
+	parser.add_option<bool>("time_applicable_ops", "measure and report the time spent generating applicable operators in red-black states "
+		"(reads the clock twice per expansion)", "false");
+}
+
+auto get_state_saturation_type(const options::Options &opts) -> StateSaturationType {
+	return static_cast<StateSaturationType>(opts.get_enum("state_saturation"));
+}
+
 auto any_conditional_effect_condition_is_red(const Painting &painting) -> int {
 	for (const auto &op : g_operators)
 		for (const auto &effect : op.get_effects())
@@ -365,4 +387,52 @@ auto get_conflicting_variables(const RedBlackDAGFactFollowingHeuristic &plan_rep
 	return conflicting_variables;
 }
 
+auto get_relaxed_plan_conflicts(const std::vector<int> &state_values, const std::vector<FactPair> &goal_facts) -> std::vector<int> {
+	// the state saturation does not support red conditional effect conditions
+	const auto rb_data = RBData(get_no_red_conditional_effect_conditions_painting(Painting(InternalPaintingType(g_root_task()->get_num_variables(), true))));
+	auto state_registry = rb_data.construct_state_registry(state_values);
+	const auto best_supporters = state_registry->get_state_and_best_supporters(state_values).second;
+	// goal facts that are not reachable in this relaxation do not cause conflicts
+	auto reachable_goal_facts = std::vector<FactPair>();
+	std::copy_if(std::begin(goal_facts), std::end(goal_facts), std::back_inserter(reachable_goal_facts), [&state_values, &best_supporters](const auto &goal_fact) {
+		return state_values[goal_fact.var] == goal_fact.value || best_supporters[goal_fact.var][goal_fact.value].get_index() != -1;
+	});
+	return get_conflicts(state_values, reachable_goal_facts, get_red_plan(best_supporters, state_values, reachable_goal_facts, true));
+}
+
+auto get_least_conflicts_candidate(const std::vector<std::vector<bool>> &candidates, const std::vector<int> &state_values, const std::vector<FactPair> &goal_facts) -> std::size_t {
+	assert(!candidates.empty());
+	if (candidates.size() == 1)
+		return 0;
+	const auto conflicts = get_relaxed_plan_conflicts(state_values, goal_facts);
+	auto best_candidate = std::size_t{0};
+	auto min_num_conflicts = std::numeric_limits<int>::max();
+	for (auto i = 0u; i < candidates.size(); ++i) {
+		auto num_conflicts = 0;
+		for (auto var = 0u; var < conflicts.size(); ++var)
+			if (candidates[i][var])
+				num_conflicts += conflicts[var];
+		if (num_conflicts < min_num_conflicts) {
+			min_num_conflicts = num_conflicts;
+			best_candidate = i;
+		}
+	}
+	return best_candidate;
+}
+
+void print_semi_relaxed_plan_statistics(const RedBlackDAGFactFollowingHeuristic &plan_repair_heuristic) {
+	const auto num_plans = plan_repair_heuristic.get_num_semi_relaxed_plans();
+	const auto plan_time = plan_repair_heuristic.get_semi_relaxed_plan_time();
+	std::cout << "Semi-relaxed plan computations: " << num_plans << " in " << plan_time << "s";
+	if (plan_time > 0)
+		std::cout << " (" << num_plans / plan_time << " per second)";
+	std::cout << std::endl;
+	const auto num_lookups = plan_repair_heuristic.get_num_semi_relaxed_plan_cache_lookups();
+	const auto num_hits = plan_repair_heuristic.get_num_semi_relaxed_plan_cache_hits();
+	std::cout << "Semi-relaxed plan cache hits: " << num_hits << "/" << num_lookups;
+	if (num_lookups > 0)
+		std::cout << " (" << (num_hits / static_cast<double>(num_lookups)) * 100 << "%)";
+	std::cout << std::endl;
+}
+
 }
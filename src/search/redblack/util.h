@@ -2,6 +2,7 @@
 #define REDBLACK_UTIL_H
 
 #include "../operator_cost.h"
+#include <chrono>
 #include <vector>
 #include <boost/dynamic_bitset/dynamic_bitset.hpp>
 
@@ -14,6 +15,7 @@ namespace redblack {
 class Painting;
 class RBState;
 class RBOperator;
+enum class StateSaturationType;
 }
 
 auto get_adjusted_action_cost(const redblack::RBOperator &op, OperatorCost cost_type) -> int;
@@ -25,11 +27,32 @@ class Options;
 }
 
 namespace redblack {
+// Measures elapsed wall-clock time. Unlike utils::Timer, which measures the CPU time of the whole process,
+// it is not affected by other threads, so it can be used for per-search time limits.
+class WallClockTimer {
+	std::chrono::steady_clock::time_point start;
+
+public:
+	WallClockTimer() : start(std::chrono::steady_clock::now()) {}
+
+	// elapsed time in seconds
+	auto operator()() const -> double {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void reset() {
+		start = std::chrono::steady_clock::now();
+	}
+};
+
 auto get_goal_facts() -> const std::vector<FactPair> &;
 
 void add_num_black_options(options::OptionParser &parser);
 auto get_num_black(const options::Options &opts, bool min_one_if_ratio = false) -> int;
 
+void add_state_saturation_options(options::OptionParser &parser);
+auto get_state_saturation_type(const options::Options &opts) -> StateSaturationType;
+
 auto any_conditional_effect_condition_is_red(const Painting &painting) -> int;
 auto get_no_red_conditional_effect_conditions_painting(const Painting &painting) -> Painting;
 
@@ -58,6 +81,13 @@ auto get_ordered_relaxed_plan(const std::vector<boost::dynamic_bitset<>> &state,
 auto get_red_plan(const std::vector<std::vector<OperatorID>> &best_supporters, const std::vector<boost::dynamic_bitset<>> &state, const std::vector<FactPair> &goal_facts, bool ordered) -> std::vector<OperatorID>;
 
 auto get_conflicting_variables(const RedBlackDAGFactFollowingHeuristic &plan_repair_heuristic, const Painting &painting) -> std::vector<int>;
+
+// conflicts (see get_conflicts) of the ordered relaxed plan from the state to the goal facts that are reachable in the delete relaxation (apart from conditional effect conditions)
+auto get_relaxed_plan_conflicts(const std::vector<int> &state_values, const std::vector<FactPair> &goal_facts) -> std::vector<int>;
+// index of the candidate painting whose red variables have the fewest relaxed plan conflicts, ties are broken in favor of the earlier candidate
+auto get_least_conflicts_candidate(const std::vector<std::vector<bool>> &candidates, const std::vector<int> &state_values, const std::vector<FactPair> &goal_facts) -> std::size_t;
+
+void print_semi_relaxed_plan_statistics(const RedBlackDAGFactFollowingHeuristic &plan_repair_heuristic);
 }
 
 
@@ -20,7 +20,8 @@ SearchEngine<GlobalState, GlobalOperator>::SearchEngine(const Options &opts)
     : status(IN_PROGRESS),
       solution_found(false),
       state_registry(std::make_shared<StateRegistryBase<GlobalState, GlobalOperator>>(
-          *g_root_task(), *g_state_packer, *g_axiom_evaluator, g_initial_state_data)),
+          *g_root_task(), *g_state_packer, *g_axiom_evaluator, g_initial_state_data,
+          opts.get<bool>("compress_states"))),
       search_space(std::make_shared<SearchSpace<GlobalState, GlobalOperator>>(*state_registry,
                    static_cast<OperatorCost>(opts.get_enum("cost_type")))),
       cost_type(static_cast<OperatorCost>(opts.get_enum("cost_type"))),
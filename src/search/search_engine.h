@@ -72,6 +72,7 @@ public:
     const SearchStatistics &get_statistics() const {return statistics; }
     void set_bound(int b) {bound = b; }
     int get_bound() {return bound; }
+    double get_max_time() const {return max_time; }
 
 	auto get_state_registry() -> StateRegistryBase<StateType, OperatorType> & { return *state_registry; }
 
@@ -223,6 +224,12 @@ void SearchEngine<StateType, OperatorType>::add_options_to_parser(options::Optio
         "experiments. Timed-out searches are treated as failed searches, "
         "just like incomplete search algorithms that exhaust their search space.",
         "infinity");
+    parser.add_option<bool>(
+        "compress_states",
+        "store registered states as deltas to their parent states. This "
+        "reduces the memory used per state, but restoring a state takes "
+        "longer than looking it up.",
+        "false");
 }
 
 /* Method doesn't belong here because it's only useful for certain derived classes.
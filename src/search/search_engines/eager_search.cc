@@ -93,6 +93,7 @@ void EagerSearch::print_checkpoint_line(int g) const {
 void EagerSearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
+    open_list->print_statistics();
     pruning_method->print_statistics();
 }
 
@@ -166,7 +166,7 @@ template<class StateType, class OperatorType>
 std::vector<OperatorID> LazySearch<StateType, OperatorType>::get_successor_operators(
     const ordered_set::OrderedSet<OperatorID> &preferred_operators) const {
     std::vector<OperatorID> applicable_operators;
-    g_successor_generator->generate_applicable_ops(
+    this->state_registry->generate_applicable_ops(
         current_state, applicable_operators);
 
     if (randomize_successors) {
@@ -324,6 +324,7 @@ template<class StateType, class OperatorType>
 void LazySearch<StateType, OperatorType>::print_statistics() const {
     this->statistics.print_detailed_statistics();
     this->search_space->print_statistics();
+    open_list->print_statistics();
 }
 
 }
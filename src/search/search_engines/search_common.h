@@ -22,6 +22,7 @@
 #include "../evaluators/sum_evaluator.h"
 #include "../evaluators/weighted_evaluator.h"
 
+#include "../open_lists/bucket_open_list.h"
 #include "../open_lists/standard_scalar_open_list.h"
 #include "../open_lists/tiebreaking_open_list.h"
 #include "../open_lists/alternation_open_list.h"
@@ -52,6 +53,19 @@ extern std::shared_ptr<OpenListFactory<StateType, OperatorType>> create_standard
     return std::make_shared<standard_scalar_open_list::StandardScalarOpenListFactory<StateType, OperatorType>>(options);
 }
 
+/*
+  Create a bucket open list factory with the given "eval" and "pref_only"
+  options. Orders the entries like the standard scalar open list.
+*/
+template<class StateType, class OperatorType>
+extern std::shared_ptr<OpenListFactory<StateType, OperatorType>> create_bucket_open_list_factory(
+    Evaluator<StateType, OperatorType> *eval, bool pref_only) {
+    options::Options options;
+    options.set("eval", eval);
+    options.set("pref_only", pref_only);
+    return std::make_shared<bucket_open_list::BucketOpenListFactory<StateType, OperatorType>>(options);
+}
+
 namespace detail {
 template<class StateType, class OperatorType>
 using GEval = g_evaluator::GEvaluator<StateType, OperatorType>;
@@ -82,16 +96,16 @@ std::shared_ptr<OpenListFactory<StateType, OperatorType>> create_alternation_ope
     const std::vector<Heuristic<StateType, OperatorType> *> &preferred_heuristics,
     int boost) {
     if (evals.size() == 1 && preferred_heuristics.empty()) {
-        return create_standard_scalar_open_list_factory(evals[0], false);
+        return create_bucket_open_list_factory(evals[0], false);
     } else {
         std::vector<std::shared_ptr<OpenListFactory<StateType, OperatorType>>> subfactories;
         for (Evaluator<StateType, OperatorType> *evaluator : evals) {
             subfactories.push_back(
-                create_standard_scalar_open_list_factory(
+                create_bucket_open_list_factory(
                     evaluator, false));
             if (!preferred_heuristics.empty()) {
                 subfactories.push_back(
-                    create_standard_scalar_open_list_factory(
+                    create_bucket_open_list_factory(
                         evaluator, true));
             }
         }
@@ -197,7 +211,7 @@ create_astar_open_list_factory_and_f_eval(const options::Options &opts) {
     options.set("pref_only", false);
     options.set("unsafe_pruning", false);
     std::shared_ptr<OpenListFactory<StateType, OperatorType>> open =
-        std::make_shared<tiebreaking_open_list::TieBreakingOpenListFactory<StateType, OperatorType>>(options);
+        std::make_shared<bucket_open_list::TieBreakingBucketOpenListFactory<StateType, OperatorType>>(options);
     return make_pair(open, f);
 }
 }
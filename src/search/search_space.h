@@ -193,6 +193,8 @@ public:
     SearchNode<StateType, OperatorType> get_node(const StateType &state);
     virtual void trace_path(const StateType &goal_state,
                             std::vector<const OperatorType *> &path) const;
+    // Returns the state at which the path traced back from the given state starts.
+    StateID get_path_start(const StateType &state) const;
 
 	// TODO: move this to a separate RBSearchSpace class
 	// returns the remaining marked facts and the path to a red-black state as
@@ -216,6 +218,17 @@ SearchNode<StateType, OperatorType> SearchSpace<StateType, OperatorType, StateRe
         state_registry, state.get_id(), search_node_infos[state], cost_type);
 }
 
+template<class StateType, class OperatorType, class StateRegistryType>
+StateID SearchSpace<StateType, OperatorType, StateRegistryType>::get_path_start(const StateType &state) const {
+    StateID current_id = state.get_id();
+    for (;;) {
+        const SearchNodeInfo &info = search_node_infos[state_registry.lookup_state(current_id)];
+        if (info.parent_state_id == StateID::no_state)
+            return current_id;
+        current_id = info.parent_state_id;
+    }
+}
+
 template<class StateType, class OperatorType, class StateRegistryType>
 void SearchSpace<StateType, OperatorType, StateRegistryType>::dump() const {
     for (StateID id : state_registry) {
@@ -237,6 +250,7 @@ template<class StateType, class OperatorType, class StateRegistryType>
 void SearchSpace<StateType, OperatorType, StateRegistryType>::print_statistics() const {
 	std::cout << "Number of registered states: "
          << state_registry.size() << std::endl;
+    state_registry.print_state_storage_statistics();
 }
 
 
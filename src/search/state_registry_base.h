@@ -3,15 +3,19 @@
 
 #include "abstract_task.h"
 #include "axioms.h"
+#include "compressed_state_pool.h"
+#include "globals.h"
 #include "per_state_information.h"
 #include "state_id.h"
 
+#include "algorithms/int_hash_set.h"
 #include "algorithms/int_packer.h"
 #include "algorithms/segmented_vector.h"
+#include "task_utils/successor_generator.h"
 #include "utils/hash.h"
 
+#include <memory>
 #include <set>
-#include <unordered_set>
 
 /*
   Overview of classes relevant to storing and working with registered states.
@@ -114,8 +118,13 @@ protected:
     // registry isn't a reference because we want to support operator=
     const StateRegistryBaseType *registry;
     StateID id;
+    // True if the buffer was restored from compressed state data and is pinned by this state.
+    bool pinned;
 
-    // Only used by the state registry.
+    /*
+      Only used by the state registry. If the registry compresses its states,
+      the buffer has to be pinned for this state, which releases it again.
+    */
     StateBase(
         const PackedStateBin *buffer, const StateRegistryBaseType &registry, StateID id);
 
@@ -127,18 +136,24 @@ protected:
         return *registry;
     }
 public:
-    virtual ~StateBase() = default;
+    StateBase(const StateBase &other);
+    StateBase(StateBase &&other);
+    /*
+      States are passed around by value in the search, so they are not
+      polymorphic. Derived state types hide operator[] and get_values if they
+      need to and provide dump_pddl() and dump_fdr().
+    */
+    ~StateBase();
+    StateBase &operator=(const StateBase &other);
+    StateBase &operator=(StateBase &&other);
 
     StateID get_id() const {
         return id;
     }
 
-    virtual int operator[](int var) const;
-
-    virtual std::vector<int> get_values() const;
+    int operator[](int var) const;
 
-    virtual void dump_pddl() const = 0;
-    virtual void dump_fdr() const = 0;
+    std::vector<int> get_values() const;
 };
 
 
@@ -160,8 +175,11 @@ class StateRegistryBase {
               state_size(state_size) {
         }
 
-        size_t operator()(StateID id) const {
-            const PackedStateBin *data = state_data_pool[id.value];
+        size_t operator()(int id) const {
+            return hash_data(state_data_pool[id]);
+        }
+
+        size_t hash_data(const PackedStateBin *data) const {
             utils::HashState hash_state;
             for (int i = 0; i < state_size; ++i) {
                 hash_state.feed(data[i]);
@@ -180,9 +198,9 @@ class StateRegistryBase {
               state_size(state_size) {
         }
 
-        bool operator()(StateID lhs, StateID rhs) const {
-            const PackedStateBin *lhs_data = state_data_pool[lhs.value];
-            const PackedStateBin *rhs_data = state_data_pool[rhs.value];
+        bool operator()(int lhs, int rhs) const {
+            const PackedStateBin *lhs_data = state_data_pool[lhs];
+            const PackedStateBin *rhs_data = state_data_pool[rhs];
             return std::equal(lhs_data, lhs_data + state_size, rhs_data);
         }
     };
@@ -192,7 +210,11 @@ class StateRegistryBase {
       this registry and find their IDs. States are compared/hashed semantically,
       i.e. the actual state data is compared, not the memory location.
     */
-    using StateIDSet = std::unordered_set<StateID, StateIDSemanticHash, StateIDSemanticEqual>;
+    using StateIDSet = int_hash_set::IntHashSet<StateIDSemanticHash, StateIDSemanticEqual>;
+
+    // States pin and release their data if it is compressed.
+    template<class>
+    friend class StateBase;
 
 protected:
     /* TODO: The state registry still doesn't use the task interface completely.
@@ -210,20 +232,48 @@ protected:
     const int num_variables;
 
     segmented_vector::SegmentedArrayVector<PackedStateBin> state_data_pool;
+    // If set, the state data is stored here instead of in state_data_pool.
+    std::unique_ptr<CompressedStatePool> compressed_state_pool;
     StateIDSet registered_states;
+    /*
+      Scratch space for building the data of a new state. It is only copied
+      into state_data_pool if it is not registered yet (see insert_state).
+    */
+    std::vector<PackedStateBin> candidate_state_data;
 
 	StateType *cached_initial_state;
     mutable std::set<PerStateInformationBase<StateType, OperatorType> *> subscribers;
 
-    StateID insert_id_or_pop_state();
+    /*
+      Returns a buffer for building the data of a new state, initialized to
+      the given data or to zero. The buffer is reused by the next call.
+    */
+    PackedStateBin *get_candidate_buffer(const PackedStateBin *data = nullptr);
+    /*
+      Returns the ID of the state with the given data, registering the state
+      first if there is none yet. The parent is only used to store the state
+      data compressed.
+    */
+    StateID insert_state(const PackedStateBin *buffer, const StateType *parent = nullptr);
+    /*
+      Returns the data of the state with the given ID. If the state data is
+      compressed, the data is restored and pinned, and has to be released
+      when it is no longer used.
+    */
+    const PackedStateBin *get_state_data(StateID id) const;
+    void retain_state_data(const PackedStateBin *data) const;
+    void release_state_data(const PackedStateBin *data) const;
+    bool stored_state_equals(int id, const PackedStateBin *buffer) const;
     int get_bins_per_state() const;
 public:
     StateRegistryBase(
         const AbstractTask &task, const int_packer::IntPacker &state_packer,
-        AxiomEvaluator &axiom_evaluator, std::vector<int> &&initial_state_data);
+        AxiomEvaluator &axiom_evaluator, std::vector<int> &&initial_state_data,
+        bool compress_states = false);
     StateRegistryBase(
         const AbstractTask &task, const int_packer::IntPacker &state_packer,
-        AxiomEvaluator &axiom_evaluator, const std::vector<int> &initial_state_data);
+        AxiomEvaluator &axiom_evaluator, const std::vector<int> &initial_state_data,
+        bool compress_states = false);
     virtual ~StateRegistryBase();
 
     /* TODO: Ideally, this should return a TaskProxy. (See comment above the
@@ -259,6 +309,21 @@ public:
     */
 	virtual StateType get_successor_state(const StateType &predecessor, const OperatorType &op);
 
+    /*
+      Returns the state of this registry with the same data as the given state
+      of another registry and registers it if this was not done before. Both
+      registries must use the same state packer.
+    */
+    StateType import_state(const StateType &state);
+
+    /*
+      Appends the operators that are applicable in the given state to
+      applicable_ops, using the global successor generator.
+    */
+    virtual void generate_applicable_ops(const StateType &state, std::vector<OperatorID> &applicable_ops) {
+        g_successor_generator->generate_applicable_ops(state, applicable_ops);
+    }
+
     /*
       Returns the number of states registered so far.
     */
@@ -268,6 +333,16 @@ public:
 
     int get_state_size_in_bytes() const;
 
+    /*
+      Returns the memory used by the data of the registered states, which is
+      less than size() * get_state_size_in_bytes() if it is compressed.
+    */
+    size_t get_state_data_memory_usage() const;
+    bool is_compressed() const {
+        return compressed_state_pool != nullptr;
+    }
+    void print_state_storage_statistics() const;
+
     /*
       Remembers the given PerStateInformation. If this StateRegistry is
       destroyed, it notifies all subscribed PerStateInformation objects.
@@ -328,34 +403,40 @@ public:
 template<class StateType, class OperatorType>
 StateRegistryBase<StateType, OperatorType>::StateRegistryBase(
     const AbstractTask &task, const int_packer::IntPacker &state_packer,
-    AxiomEvaluator &axiom_evaluator, std::vector<int> &&initial_state_data)
+    AxiomEvaluator &axiom_evaluator, std::vector<int> &&initial_state_data,
+    bool compress_states)
     : task(task),
       state_packer(state_packer),
       axiom_evaluator(axiom_evaluator),
       initial_state_data(std::move(initial_state_data)),
       num_variables(this->initial_state_data.size()),
       state_data_pool(get_bins_per_state()),
+      compressed_state_pool(
+          compress_states ? new CompressedStatePool(get_bins_per_state()) : nullptr),
       registered_states(
-          0,
           StateIDSemanticHash(state_data_pool, get_bins_per_state()),
           StateIDSemanticEqual(state_data_pool, get_bins_per_state())),
+      candidate_state_data(get_bins_per_state()),
       cached_initial_state(0) {
 }
 
 template<class StateType, class OperatorType>
 StateRegistryBase<StateType, OperatorType>::StateRegistryBase(
     const AbstractTask &task, const int_packer::IntPacker &state_packer,
-    AxiomEvaluator &axiom_evaluator, const std::vector<int> &initial_state_data)
+    AxiomEvaluator &axiom_evaluator, const std::vector<int> &initial_state_data,
+    bool compress_states)
     : task(task),
       state_packer(state_packer),
       axiom_evaluator(axiom_evaluator),
       initial_state_data(initial_state_data),
       num_variables(this->initial_state_data.size()),
       state_data_pool(get_bins_per_state()),
+      compressed_state_pool(
+          compress_states ? new CompressedStatePool(get_bins_per_state()) : nullptr),
       registered_states(
-          0,
           StateIDSemanticHash(state_data_pool, get_bins_per_state()),
           StateIDSemanticEqual(state_data_pool, get_bins_per_state())),
+      candidate_state_data(get_bins_per_state()),
       cached_initial_state(0) {
 }
 
@@ -367,42 +448,94 @@ StateRegistryBase<StateType, OperatorType>::~StateRegistryBase() {
 }
 
 template<class StateType, class OperatorType>
-StateID StateRegistryBase<StateType, OperatorType>::insert_id_or_pop_state() {
+PackedStateBin *StateRegistryBase<StateType, OperatorType>::get_candidate_buffer(const PackedStateBin *data) {
+    if (data)
+        std::copy(data, data + candidate_state_data.size(), candidate_state_data.begin());
+    else
+        std::fill(candidate_state_data.begin(), candidate_state_data.end(), 0);
+    return candidate_state_data.data();
+}
+
+template<class StateType, class OperatorType>
+StateID StateRegistryBase<StateType, OperatorType>::insert_state(
+    const PackedStateBin *buffer, const StateType *parent) {
     /*
-      Attempt to insert a StateID for the last state of state_data_pool
-      if none is present yet. If this fails (another entry for this state
-      is present), we have to remove the duplicate entry from the
-      state data pool.
+      Look the state up by its data before storing it, so that duplicates
+      never touch the state storage.
     */
-    StateID id(state_data_pool.size() - 1);
-    std::pair<typename StateIDSet::iterator, bool> result = registered_states.insert(id);
-    bool is_new_entry = result.second;
-    if (!is_new_entry) {
-        state_data_pool.pop_back();
-    }
-    assert(registered_states.size() == state_data_pool.size());
-    return *result.first;
+    std::pair<int, bool> result = registered_states.insert_value(
+        StateIDSemanticHash(state_data_pool, get_bins_per_state()).hash_data(buffer),
+        [this, buffer](int id) {
+            return stored_state_equals(id, buffer);
+        },
+        [this, buffer, parent]() {
+            if (compressed_state_pool) {
+                if (parent)
+                    return compressed_state_pool->push_back(
+                        buffer, parent->get_id().value, parent->get_packed_buffer());
+                return compressed_state_pool->push_back(buffer, -1, nullptr);
+            }
+            state_data_pool.push_back(buffer);
+            return static_cast<int>(state_data_pool.size()) - 1;
+        });
+    assert(registered_states.size() == static_cast<int>(
+               compressed_state_pool ? compressed_state_pool->size() : state_data_pool.size()));
+    return StateID(result.first);
+}
+
+template<class StateType, class OperatorType>
+const PackedStateBin *StateRegistryBase<StateType, OperatorType>::get_state_data(
+    StateID id) const {
+    if (compressed_state_pool)
+        return compressed_state_pool->get(id.value);
+    return state_data_pool[id.value];
+}
+
+template<class StateType, class OperatorType>
+void StateRegistryBase<StateType, OperatorType>::retain_state_data(
+    const PackedStateBin *data) const {
+    if (compressed_state_pool)
+        compressed_state_pool->pin(data);
+}
+
+template<class StateType, class OperatorType>
+void StateRegistryBase<StateType, OperatorType>::release_state_data(
+    const PackedStateBin *data) const {
+    if (compressed_state_pool)
+        compressed_state_pool->unpin(data);
+}
+
+template<class StateType, class OperatorType>
+bool StateRegistryBase<StateType, OperatorType>::stored_state_equals(
+    int id, const PackedStateBin *buffer) const {
+    const PackedStateBin *data = get_state_data(StateID(id));
+    bool equal = std::equal(data, data + get_bins_per_state(), buffer);
+    release_state_data(data);
+    return equal;
 }
 
 template<class StateType, class OperatorType>
 const StateType &StateRegistryBase<StateType, OperatorType>::get_initial_state() {
     if (cached_initial_state == 0) {
-        PackedStateBin *buffer = new PackedStateBin[get_bins_per_state()];
-        // Avoid garbage values in half-full bins.
-        std::fill_n(buffer, get_bins_per_state(), 0);
+        // Zero-initialized to avoid garbage values in half-full bins.
+        PackedStateBin *buffer = get_candidate_buffer();
         for (size_t i = 0; i < initial_state_data.size(); ++i) {
             state_packer.set(buffer, i, initial_state_data[i]);
         }
         axiom_evaluator.evaluate(buffer, state_packer);
-        state_data_pool.push_back(buffer);
-        // buffer is copied by push_back
-        delete[] buffer;
-        StateID id = insert_id_or_pop_state();
+        StateID id = insert_state(buffer);
         cached_initial_state = new StateType(lookup_state(id));
     }
     return *cached_initial_state;
 }
 
+template<class StateType, class OperatorType>
+StateType StateRegistryBase<StateType, OperatorType>::import_state(const StateType &state) {
+    assert(&state.get_registry().state_packer == &state_packer);
+    StateID id = insert_state(state.get_packed_buffer());
+    return lookup_state(id);
+}
+
 template<class StateType, class OperatorType>
 int StateRegistryBase<StateType, OperatorType>::get_bins_per_state() const {
     return state_packer.get_num_bins();
@@ -413,6 +546,24 @@ int StateRegistryBase<StateType, OperatorType>::get_state_size_in_bytes() const
     return get_bins_per_state() * sizeof(PackedStateBin);
 }
 
+template<class StateType, class OperatorType>
+size_t StateRegistryBase<StateType, OperatorType>::get_state_data_memory_usage() const {
+    if (compressed_state_pool)
+        return compressed_state_pool->estimate_memory_usage();
+    return size() * get_state_size_in_bytes();
+}
+
+template<class StateType, class OperatorType>
+void StateRegistryBase<StateType, OperatorType>::print_state_storage_statistics() const {
+    if (!compressed_state_pool)
+        return;
+    compressed_state_pool->print_statistics();
+    if (size() > 0)
+        std::cout << "Stored bytes per state: "
+                  << static_cast<double>(get_state_data_memory_usage()) / size()
+                  << " (uncompressed: " << get_state_size_in_bytes() << ")" << std::endl;
+}
+
 template<class StateType, class OperatorType>
 void StateRegistryBase<StateType, OperatorType>::subscribe(PerStateInformationBase<StateType, OperatorType> *psi) const {
     subscribers.insert(psi);
@@ -429,11 +580,66 @@ StateBase<StateRegistryBaseType>::StateBase(
     const PackedStateBin *buffer, const StateRegistryBaseType &registry, StateID id)
     : buffer(buffer),
       registry(&registry),
-      id(id) {
+      id(id),
+      pinned(registry.is_compressed()) {
     assert(buffer);
     assert(id != StateID::no_state);
 }
 
+template<class StateRegistryBaseType>
+StateBase<StateRegistryBaseType>::StateBase(const StateBase &other)
+    : buffer(other.buffer),
+      registry(other.registry),
+      id(other.id),
+      pinned(other.pinned) {
+    if (pinned)
+        registry->retain_state_data(buffer);
+}
+
+template<class StateRegistryBaseType>
+StateBase<StateRegistryBaseType>::StateBase(StateBase &&other)
+    : buffer(other.buffer),
+      registry(other.registry),
+      id(other.id),
+      pinned(other.pinned) {
+    other.pinned = false;
+}
+
+template<class StateRegistryBaseType>
+StateBase<StateRegistryBaseType>::~StateBase() {
+    if (pinned)
+        registry->release_state_data(buffer);
+}
+
+template<class StateRegistryBaseType>
+StateBase<StateRegistryBaseType> &StateBase<StateRegistryBaseType>::operator=(
+    const StateBase &other) {
+    if (other.pinned)
+        other.registry->retain_state_data(other.buffer);
+    if (pinned)
+        registry->release_state_data(buffer);
+    buffer = other.buffer;
+    registry = other.registry;
+    id = other.id;
+    pinned = other.pinned;
+    return *this;
+}
+
+template<class StateRegistryBaseType>
+StateBase<StateRegistryBaseType> &StateBase<StateRegistryBaseType>::operator=(
+    StateBase &&other) {
+    if (this != &other) {
+        if (pinned)
+            registry->release_state_data(buffer);
+        buffer = other.buffer;
+        registry = other.registry;
+        id = other.id;
+        pinned = other.pinned;
+        other.pinned = false;
+    }
+    return *this;
+}
+
 template<class StateRegistryBaseType>
 int StateBase<StateRegistryBaseType>::operator[](int var) const {
     assert(var >= 0);
@@ -12,6 +12,10 @@ SuccessorGenerator::SuccessorGenerator(const TaskProxy &task_proxy)
     : root(SuccessorGeneratorFactory(task_proxy).create()) {
 }
 
+SuccessorGenerator::SuccessorGenerator(const TaskProxy &task_proxy, const redblack::Painting &painting)
+	: root(SuccessorGeneratorFactory(task_proxy, &painting).create()) {
+}
+
 SuccessorGenerator::~SuccessorGenerator() = default;
 
 void SuccessorGenerator::generate_applicable_ops(
@@ -10,6 +10,7 @@ class State;
 class TaskProxy;
 
 namespace redblack {
+class Painting;
 class RBState;
 }
 
@@ -21,6 +22,8 @@ class SuccessorGenerator {
 
 public:
     explicit SuccessorGenerator(const TaskProxy &task_proxy);
+	// red-black: generator that only switches on the black variables of the painting
+	SuccessorGenerator(const TaskProxy &task_proxy, const redblack::Painting &painting);
     /*
       We cannot use the default destructor (implicitly or explicitly)
       here because GeneratorBase is a forward declaration and the
@@ -3,6 +3,7 @@
 #include "successor_generator_internals.h"
 
 #include "../task_proxy.h"
+#include "../redblack/painting.h"
 
 #include "../utils/collections.h"
 #include "../utils/memory.h"
@@ -166,8 +167,9 @@ public:
 
 
 SuccessorGeneratorFactory::SuccessorGeneratorFactory(
-    const TaskProxy &task_proxy)
-    : task_proxy(task_proxy) {
+    const TaskProxy &task_proxy, const redblack::Painting *painting)
+    : task_proxy(task_proxy),
+      painting(painting) {
 }
 
 SuccessorGeneratorFactory::~SuccessorGeneratorFactory() = default;
@@ -197,6 +199,9 @@ GeneratorPtr SuccessorGeneratorFactory::construct_leaf(
         ++range.begin;
     }
 
+	if (painting && std::any_of(std::begin(operators), std::end(operators), [this](const auto op_id) { return !red_preconditions[op_id.get_index()].empty(); }))
+		return utils::make_unique_ptr<GeneratorLeafRedPreconditions>(move(operators), red_preconditions);
+
     if (operators.size() == 1) {
         return utils::make_unique_ptr<GeneratorLeafSingle>(operators.front());
     } else {
@@ -283,9 +288,19 @@ static vector<FactPair> build_sorted_precondition(const OperatorProxy &op) {
 GeneratorPtr SuccessorGeneratorFactory::create() {
     OperatorsProxy operators = task_proxy.get_operators();
     operator_infos.reserve(operators.size());
+	if (painting)
+		red_preconditions.resize(operators.size());
     for (OperatorProxy op : operators) {
+		auto precondition = build_sorted_precondition(op);
+		if (painting) {
+			// only black preconditions are tested by switch nodes
+			auto red_begin = std::stable_partition(std::begin(precondition), std::end(precondition),
+				[this](const auto &fact) { return painting->is_black_var(fact.var); });
+			red_preconditions[op.get_id()].assign(red_begin, std::end(precondition));
+			precondition.erase(red_begin, std::end(precondition));
+		}
         operator_infos.emplace_back(
-            OperatorID(op.get_id()), build_sorted_precondition(op));
+            OperatorID(op.get_id()), move(precondition));
     }
     /* Use stable_sort rather than sort for reproducibility.
        This amounts to breaking ties by operator ID. */
@@ -294,6 +309,7 @@ GeneratorPtr SuccessorGeneratorFactory::create() {
     OperatorRange full_range(0, operator_infos.size());
     GeneratorPtr root = construct_recursive(0, full_range);
     operator_infos.clear();
+	red_preconditions.clear();
     return root;
 }
 }
@@ -1,11 +1,17 @@
 #ifndef TASK_UTILS_SUCCESSOR_GENERATOR_FACTORY_H
 #define TASK_UTILS_SUCCESSOR_GENERATOR_FACTORY_H
 
+#include "../abstract_task.h"
+
 #include <memory>
 #include <vector>
 
 class TaskProxy;
 
+namespace redblack {
+class Painting;
+}
+
 namespace successor_generator {
 class GeneratorBase;
 
@@ -20,6 +26,9 @@ class SuccessorGeneratorFactory {
 
     const TaskProxy &task_proxy;
     std::vector<OperatorInfo> operator_infos;
+	// red-black: if given, switch nodes only test black variables, red preconditions are tested in the leaves
+	const redblack::Painting *painting;
+	std::vector<std::vector<FactPair>> red_preconditions;
 
     GeneratorPtr construct_fork(std::vector<GeneratorPtr> nodes) const;
     GeneratorPtr construct_leaf(OperatorRange range) const;
@@ -27,7 +36,7 @@ class SuccessorGeneratorFactory {
         int switch_var_id, ValuesAndGenerators generator_for_value) const;
     GeneratorPtr construct_recursive(int depth, OperatorRange range) const;
 public:
-    explicit SuccessorGeneratorFactory(const TaskProxy &task_proxy);
+    explicit SuccessorGeneratorFactory(const TaskProxy &task_proxy, const redblack::Painting *painting = nullptr);
     // Destructor cannot be implicit because OperatorInfo is forward-declared.
     ~SuccessorGeneratorFactory();
     GeneratorPtr create();
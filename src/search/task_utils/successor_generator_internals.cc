@@ -306,4 +306,55 @@ void GeneratorLeafSingle::generate_applicable_ops(
 	if (!black_only || operator_affects_black_variable(state, applicable_operator))
 		applicable_ops.push_back(applicable_operator);
 }
+
+GeneratorLeafRedPreconditions::GeneratorLeafRedPreconditions(vector<OperatorID> &&applicable_operators, const vector<vector<FactPair>> &red_preconditions)
+	: applicable_operators(move(applicable_operators)),
+	  red_preconditions_begin(),
+	  red_preconditions() {
+	red_preconditions_begin.reserve(this->applicable_operators.size() + 1);
+	red_preconditions_begin.push_back(0);
+	for (const auto op_id : this->applicable_operators) {
+		const auto &op_red_preconditions = red_preconditions[op_id.get_index()];
+		this->red_preconditions.insert(std::end(this->red_preconditions), std::begin(op_red_preconditions), std::end(op_red_preconditions));
+		red_preconditions_begin.push_back(this->red_preconditions.size());
+	}
+}
+
+template<class StateType>
+auto GeneratorLeafRedPreconditions::has_red_preconditions(const StateType &state, int index) const -> bool {
+	for (auto i = red_preconditions_begin[index]; i < red_preconditions_begin[index + 1]; ++i) {
+		if constexpr (std::is_same_v<StateType, redblack::RBState>) {
+			if (!state.has_fact(red_preconditions[i].var, red_preconditions[i].value))
+				return false;
+		} else if constexpr (std::is_same_v<StateType, State>) {
+			if (state[red_preconditions[i].var].get_value() != red_preconditions[i].value)
+				return false;
+		} else {
+			if (state[red_preconditions[i].var] != red_preconditions[i].value)
+				return false;
+		}
+	}
+	return true;
+}
+
+void GeneratorLeafRedPreconditions::generate_applicable_ops(
+	const State &state, vector<OperatorID> &applicable_ops) const {
+	for (auto i = 0u; i < applicable_operators.size(); ++i)
+		if (has_red_preconditions(state, i))
+			applicable_ops.push_back(applicable_operators[i]);
+}
+
+void GeneratorLeafRedPreconditions::generate_applicable_ops(
+	const GlobalState &state, vector<OperatorID> &applicable_ops) const {
+	for (auto i = 0u; i < applicable_operators.size(); ++i)
+		if (has_red_preconditions(state, i))
+			applicable_ops.push_back(applicable_operators[i]);
+}
+
+void GeneratorLeafRedPreconditions::generate_applicable_ops(
+	const redblack::RBState &state, vector<OperatorID> &applicable_ops, bool black_only) const {
+	for (auto i = 0u; i < applicable_operators.size(); ++i)
+		if (has_red_preconditions(state, i) && (!black_only || operator_affects_black_variable(state, applicable_operators[i])))
+			applicable_ops.push_back(applicable_operators[i]);
+}
 }
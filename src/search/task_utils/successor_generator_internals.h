@@ -1,6 +1,7 @@
 #ifndef TASK_UTILS_SUCCESSOR_GENERATOR_INTERNALS_H
 #define TASK_UTILS_SUCCESSOR_GENERATOR_INTERNALS_H
 
+#include "../abstract_task.h"
 #include "../operator_id.h"
 #include "../redblack/state.h"
 
@@ -134,6 +135,25 @@ public:
 	void generate_applicable_ops(
 		const redblack::RBState &state, std::vector<OperatorID> &applicable_ops, bool black_only = true) const override;
 };
+
+// red-black: leaf of a painting-specific generator, tests the preconditions on red variables that the switch nodes skip
+class GeneratorLeafRedPreconditions : public GeneratorBase {
+	std::vector<OperatorID> applicable_operators;
+	// red preconditions of applicable_operators[i] are red_preconditions[red_preconditions_begin[i]] up to red_preconditions_begin[i + 1]
+	std::vector<int> red_preconditions_begin;
+	std::vector<FactPair> red_preconditions;
+
+	template<class StateType>
+	auto has_red_preconditions(const StateType &state, int index) const -> bool;
+public:
+	GeneratorLeafRedPreconditions(std::vector<OperatorID> &&applicable_operators, const std::vector<std::vector<FactPair>> &red_preconditions);
+	void generate_applicable_ops(
+		const State &state, std::vector<OperatorID> &applicable_ops) const override;
+	void generate_applicable_ops(
+		const GlobalState &state, std::vector<OperatorID> &applicable_ops) const override;
+	void generate_applicable_ops(
+		const redblack::RBState &state, std::vector<OperatorID> &applicable_ops, bool black_only = true) const override;
+};
 }
 
 #endif